@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <streambuf>
+#include <string>
+
+// Shared datasets for the ip_filter benchmarks.
+
+// Read-only streambuf over an existing string, so that every iteration starts
+// from the same dataset without copying gigabytes into an istringstream.
+class ViewBuf : public std::streambuf {
+public:
+    explicit ViewBuf(std::string &data) {
+        setg(data.data(), data.data(), data.data() + data.size());
+    }
+};
+
+inline std::string const &sample_lines() {
+    static const std::string sample = [] {
+        std::ifstream ifs(IP_FILTER_SAMPLE_TSV);
+        return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }();
+    return sample;
+}
+
+// tests/data/ip.tsv repeated until it holds `lines` lines
+inline std::string make_dataset(std::size_t lines) {
+    std::string const &sample = sample_lines();
+    std::string data;
+
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < lines; ++i) {
+        auto eol = sample.find('\n', begin);
+        if (eol == std::string::npos) {
+            begin = 0;
+            eol = sample.find('\n');
+        }
+        data.append(sample, begin, eol - begin + 1);
+        begin = eol + 1;
+    }
+    return data;
+}
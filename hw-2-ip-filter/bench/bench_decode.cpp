@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "include/data_structs.hpp"
+#include "include/ip_decode.hpp"
+
+namespace {
+
+// address fields of tests/data/ip.tsv
+std::vector<std::string> const &sample_fields() {
+    static const std::vector<std::string> fields = [] {
+        std::vector<std::string> result;
+        std::ifstream ifs(IP_FILTER_SAMPLE_TSV);
+        for (std::string line; std::getline(ifs, line);) {
+            result.push_back(line.substr(0, line.find('\t')));
+        }
+        return result;
+    }();
+    return fields;
+}
+
+template <typename Decode>
+void run_decode(benchmark::State &state, Decode decode) {
+    auto const &fields = sample_fields();
+
+    for (auto _ : state) {
+        for (auto const &field : fields) {
+            benchmark::DoNotOptimize(decode(field));
+        }
+    }
+
+    const auto addresses = static_cast<double>(fields.size());
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(fields.size()));
+    // inverted rate, i.e. seconds per address (printed as "...ns")
+    state.counters["time_per_addr"] = benchmark::Counter(
+        addresses, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+void BM_DecodeMakeIp(benchmark::State &state) {
+    run_decode(state, [](std::string const &field) { return make_ip(split(field, '.')); });
+}
+
+void BM_DecodeScalar(benchmark::State &state) {
+    run_decode(state, [](std::string_view field) { return decode_ipv4_scalar(field); });
+}
+
+void BM_DecodeSse41(benchmark::State &state) {
+    if (!has_sse41_decoder()) {
+        state.SkipWithError("SSE4.1 kernel not available on this CPU");
+        return;
+    }
+    run_decode(state, [](std::string_view field) { return decode_ipv4_sse41(field); });
+}
+
+} // namespace
+
+BENCHMARK(BM_DecodeMakeIp);
+BENCHMARK(BM_DecodeScalar);
+BENCHMARK(BM_DecodeSse41);
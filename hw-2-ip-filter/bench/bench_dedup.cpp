@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "include/data_structs.hpp"
+#include "include/dedup.hpp"
+
+namespace {
+
+// 10M addresses drawn from `distinct` different values
+std::vector<std::uint32_t> skewed_stream(std::size_t distinct) {
+    std::mt19937 rng(31);
+    std::vector<std::uint32_t> stream(10'000'000);
+    for (auto &address : stream) address = static_cast<std::uint32_t>(rng() % distinct) * 2654435761u;
+    return stream;
+}
+
+// baseline: materialize, sort, unique
+void BM_DedupSortUnique(benchmark::State &state) {
+    const auto stream = skewed_stream(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        std::vector<CompactIP> pool(stream.begin(), stream.end());
+        CompactIP::sort_reverse_lex(pool);
+        pool.erase(std::unique(pool.begin(), pool.end()), pool.end());
+        benchmark::DoNotOptimize(pool.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(stream.size()));
+}
+
+void BM_DedupUniqueSet(benchmark::State &state) {
+    const auto stream = skewed_stream(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        UniqueAddressSet unique;
+        for (auto address : stream) unique.insert(address);
+
+        std::size_t visited = 0;
+        unique.visit_descending([&visited](std::uint32_t) { ++visited; });
+        benchmark::DoNotOptimize(visited);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(stream.size()));
+}
+
+void BM_TopKCounter(benchmark::State &state) {
+    const auto stream = skewed_stream(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        TopKCounter counter;
+        for (auto address : stream) counter.add(address);
+        benchmark::DoNotOptimize(counter.top(100).data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(stream.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_DedupSortUnique)->Arg(1'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DedupUniqueSet)->Arg(1'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TopKCounter)->Arg(1'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <vector>
+
+#include "include/data_structs.hpp"
+#include "include/filter_engine.hpp"
+
+namespace {
+
+// discards everything, so that only formatting is measured
+class NullBuf : public std::streambuf {
+protected:
+    std::streamsize xsputn(char const *, std::streamsize n) override { return n; }
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+};
+
+std::vector<CompactIP> sorted_pool(std::size_t n) {
+    std::mt19937 rng(7);
+    std::vector<CompactIP> pool;
+    pool.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        // bias towards 1.* and 46.* so that every filter has matches
+        auto address = static_cast<std::uint32_t>(rng());
+        if (i % 4 == 0) address = (address & 0x00FFFFFFu) | (i % 8 == 0 ? 0x01000000u : 0x2E000000u);
+        pool.emplace_back(address);
+    }
+    CompactIP::sort_reverse_lex(pool);
+    return pool;
+}
+
+// the original main: four passes, std::string per printed line
+void BM_FilterFourPassIostream(benchmark::State &state) {
+    const auto pool = sorted_pool(static_cast<std::size_t>(state.range(0)));
+    NullBuf null;
+    std::ostream out(&null);
+
+    for (auto _ : state) {
+        for (auto const &ip : pool) out << ip.to_string() << '\n';
+        for (auto const &ip : pool) {
+            if (ip.bytes()[0] == 1) out << ip.to_string() << '\n';
+        }
+        for (auto const &ip : pool) {
+            auto b = ip.bytes();
+            if (b[0] == 46 && b[1] == 70) out << ip.to_string() << '\n';
+        }
+        for (auto const &ip : pool) {
+            if (std::ranges::any_of(ip.bytes(), [](int v) { return v == 46; })) out << ip.to_string() << '\n';
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_FilterEngine(benchmark::State &state) {
+    const auto pool = sorted_pool(static_cast<std::size_t>(state.range(0)));
+    NullBuf null;
+    std::ostream out(&null);
+
+    for (auto _ : state) {
+        FilterEngine engine({AddressFilter::all(), AddressFilter::prefix(0x01000000, 8),
+                             AddressFilter::prefix(0x2E460000, 16), AddressFilter::any_octet(46)});
+        engine.run(pool);
+        engine.write_to(out);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_FilterFourPassIostream)->RangeMultiplier(10)->Range(1'000, 10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FilterEngine)->RangeMultiplier(10)->Range(1'000, 10'000'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "include/data_structs.hpp"
+#include "include/filter_engine.hpp"
+#include "include/prefix_index.hpp"
+
+namespace {
+
+std::vector<CompactIP> const &index_pool() {
+    static const std::vector<CompactIP> pool = [] {
+        std::mt19937 rng(11);
+        std::vector<CompactIP> result;
+        for (int i = 0; i < 10'000'000; ++i) result.emplace_back(static_cast<std::uint32_t>(rng()));
+        CompactIP::sort_reverse_lex(result);
+        return result;
+    }();
+    return pool;
+}
+
+void BM_PrefixLinearScan(benchmark::State &state) {
+    auto const &pool = index_pool();
+    const auto filter = AddressFilter::prefix(0x2E460000, static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        std::size_t matches = 0;
+        for (auto const &ip : pool) matches += filter(ip.collapsed());
+        benchmark::DoNotOptimize(matches);
+    }
+}
+
+void BM_PrefixIndexLookup(benchmark::State &state) {
+    auto const &pool = index_pool();
+    const PrefixIndex index(pool);
+    const Cidr cidr{0x2E460000, static_cast<int>(state.range(0))};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.prefix(cidr).size());
+    }
+}
+
+// Both variants collect the matches, as a consumer printing them would. On
+// this uniform pool nearly every /16 bucket contains a 46 somewhere, so the
+// bucket bitmap can skip little; skewed real-world pools prune much more.
+void BM_AnyOctetLinearScan(benchmark::State &state) {
+    auto const &pool = index_pool();
+    const auto filter = AddressFilter::any_octet(46);
+    std::vector<CompactIP> matches;
+
+    for (auto _ : state) {
+        matches.clear();
+        for (auto const &ip : pool) {
+            if (filter(ip.collapsed())) matches.push_back(ip);
+        }
+        benchmark::DoNotOptimize(matches.data());
+    }
+}
+
+void BM_AnyOctetIndex(benchmark::State &state) {
+    auto const &pool = index_pool();
+    const PrefixIndex index(pool);
+    std::vector<CompactIP> matches;
+
+    for (auto _ : state) {
+        matches.clear();
+        index.visit_any_octet(46, [&matches](auto run) { matches.insert(matches.end(), run.begin(), run.end()); });
+        benchmark::DoNotOptimize(matches.data());
+    }
+}
+
+void BM_PrefixIndexBuild(benchmark::State &state) {
+    auto const &pool = index_pool();
+
+    for (auto _ : state) {
+        PrefixIndex index(pool);
+        benchmark::DoNotOptimize(index.boundaries().data());
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_PrefixLinearScan)->Arg(8)->Arg(16)->Arg(24)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PrefixIndexLookup)->Arg(8)->Arg(16)->Arg(24);
+BENCHMARK(BM_AnyOctetLinearScan)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AnyOctetIndex)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PrefixIndexBuild)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+
+#include "bench/bench_data.hpp"
+#include "include/data_structs.hpp"
+#include "include/ingest.hpp"
+
+namespace {
+
+constexpr std::size_t kIngestLines = 10'000'000;
+
+std::string const &ingest_dataset() {
+    static const std::string data = make_dataset(kIngestLines);
+    return data;
+}
+
+// sequential baseline: one block parse + radix sort
+void BM_IngestSequential(benchmark::State &state) {
+    auto const &data = ingest_dataset();
+
+    for (auto _ : state) {
+        std::vector<CompactIP> ip_pool;
+        parse_compact_ip_block(data, ip_pool);
+        CompactIP::sort_reverse_lex(ip_pool);
+        benchmark::DoNotOptimize(ip_pool.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kIngestLines));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+// speedup curve: compare real time against BM_IngestSequential
+void BM_IngestParallel(benchmark::State &state) {
+    auto const &data = ingest_dataset();
+    const auto threads = static_cast<unsigned>(state.range(0));
+
+    for (auto _ : state) {
+        auto ip_pool = parse_sorted_parallel(data, threads);
+        benchmark::DoNotOptimize(ip_pool.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kIngestLines));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_IngestSequential)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_IngestParallel)->RangeMultiplier(2)->Range(1, 32)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "include/data_structs.hpp"
+#include "include/ingest.hpp"
+
+namespace {
+
+std::vector<IP6> random_ip6_pool(std::size_t n) {
+    std::mt19937_64 rng(37);
+    std::vector<IP6> pool;
+    pool.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        // 2001:db8::/32-like prefixes with sparse interface ids
+        pool.emplace_back(0x20010DB800000000ull | (rng() & 0xFFFFFFFF), rng() & rng());
+    }
+    return pool;
+}
+
+std::string ip6_dataset(std::vector<IP6> const &pool) {
+    std::string data;
+    for (auto const &ip : pool) data += ip.to_string() + "\t1\t0\n";
+    return data;
+}
+
+void BM_ParseIP6(benchmark::State &state) {
+    const auto pool = random_ip6_pool(1 << 16);
+    std::vector<std::string> texts;
+    for (auto const &ip : pool) texts.push_back(ip.to_string());
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parse_ip6(texts[i++ & 0xFFFF]));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_SortIP6(benchmark::State &state) {
+    const auto pool = random_ip6_pool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto copy = pool;
+        state.ResumeTiming();
+
+        IP6::sort_reverse_lex(copy);
+        benchmark::DoNotOptimize(copy.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SortIP6Std(benchmark::State &state) {
+    const auto pool = random_ip6_pool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto copy = pool;
+        state.ResumeTiming();
+
+        std::ranges::sort(copy, std::greater<>{});
+        benchmark::DoNotOptimize(copy.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// mixed half/half input through the chunked pipeline
+void BM_IngestMixed(benchmark::State &state) {
+    static const std::string data = [] {
+        std::string text = ip6_dataset(random_ip6_pool(2'000'000));
+        std::mt19937 rng(41);
+        for (int i = 0; i < 2'000'000; ++i) text += CompactIP(static_cast<std::uint32_t>(rng())).to_string() + "\t1\t0\n";
+        return text;
+    }();
+    const auto threads = static_cast<unsigned>(state.range(0));
+
+    for (auto _ : state) {
+        auto pools = parse_ip_pools_parallel(data, threads);
+        benchmark::DoNotOptimize(pools.ipv6.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * 4'000'000);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_ParseIP6);
+BENCHMARK(BM_SortIP6)->RangeMultiplier(10)->Range(1'000, 10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortIP6Std)->RangeMultiplier(10)->Range(1'000, 10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IngestMixed)->RangeMultiplier(2)->Range(1, 16)->Unit(benchmark::kMillisecond)->UseRealTime();
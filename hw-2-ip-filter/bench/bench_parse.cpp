@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "bench/bench_data.hpp"
+#include "include/data_structs.hpp"
+
+namespace {
+
+void BM_ParseFromPipe(benchmark::State &state) {
+    auto data = make_dataset(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        ViewBuf buf(data);
+        auto cin_buf = std::cin.rdbuf(&buf);
+        auto ips = parse_ip_from_pipe();
+        std::cin.rdbuf(cin_buf);
+        benchmark::DoNotOptimize(ips.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+void BM_ParseFromStream(benchmark::State &state) {
+    auto data = make_dataset(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        ViewBuf buf(data);
+        std::istream in(&buf);
+        auto ips = parse_ip_from_stream(in);
+        benchmark::DoNotOptimize(ips.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_ParseFromPipe)->RangeMultiplier(10)->Range(1'000, 100'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseFromStream)->RangeMultiplier(10)->Range(1'000, 100'000'000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
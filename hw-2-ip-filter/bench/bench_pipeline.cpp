@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench/bench_data.hpp"
+#include "include/data_structs.hpp"
+
+// One benchmark per step of the original getline -> split -> make_ip -> sort
+// -> to_string pipeline, each on 1K..100M addresses. The sort step is
+// BM_SortIP in bench_sort.cpp. Use `cmake --build . --target
+// ip_filter_bench_json` to get a JSON report.
+
+namespace {
+
+// first field of every line of a make_dataset() text
+std::vector<std::string_view> address_fields(std::string const &data) {
+    std::vector<std::string_view> fields;
+    for (std::size_t begin = 0; begin < data.size();) {
+        const auto eol = data.find('\n', begin);
+        const auto line = std::string_view(data).substr(begin, eol - begin);
+        fields.push_back(line.substr(0, line.find('\t')));
+        begin = eol + 1;
+    }
+    return fields;
+}
+
+// octets of `lines` addresses as NUL-terminated strings back to back;
+// parse_int reads up to the terminator, not up to the view's end
+std::string octet_texts(std::size_t lines) {
+    const auto data = make_dataset(lines);
+    std::string texts;
+    texts.reserve(data.size());
+    for (auto field : address_fields(data)) {
+        for (auto octet : field | std::views::split('.')) {
+            texts.append(octet.begin(), octet.end());
+            texts.push_back('\0');
+        }
+    }
+    return texts;
+}
+
+std::vector<std::uint32_t> random_addresses(std::size_t n) {
+    std::mt19937 rng(12345);
+    std::vector<std::uint32_t> result(n);
+    for (auto &address : result) address = static_cast<std::uint32_t>(rng());
+    return result;
+}
+
+// split() on a whole line, including the std::string the pipe parser reads it into
+void BM_Split(benchmark::State &state) {
+    const auto data = make_dataset(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        for (std::size_t begin = 0; begin < data.size();) {
+            const auto eol = data.find('\n', begin);
+            const std::string line(data, begin, eol - begin);
+            benchmark::DoNotOptimize(split(line, '\t'));
+            begin = eol + 1;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+template <auto Parse>
+void run_octet_parse(benchmark::State &state) {
+    const auto texts = octet_texts(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        for (char const *cursor = texts.data(); cursor != texts.data() + texts.size();) {
+            const std::string_view octet(cursor);
+            benchmark::DoNotOptimize(Parse(octet));
+            cursor += octet.size() + 1;
+        }
+    }
+
+    // items are octets, four per address
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 4);
+}
+
+void BM_ParseInt(benchmark::State &state) {
+    run_octet_parse<parse_int>(state);
+}
+
+void BM_ParseOctet(benchmark::State &state) {
+    run_octet_parse<parse_octet>(state);
+}
+
+void BM_MakeIp(benchmark::State &state) {
+    const auto data = make_dataset(static_cast<std::size_t>(state.range(0)));
+    const auto fields = address_fields(data);
+
+    for (auto _ : state) {
+        for (auto field : fields) benchmark::DoNotOptimize(make_ip(field | std::views::split('.')));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// IP is built from the collapsed address per call, to keep 100M runs in memory
+void BM_ToString(benchmark::State &state) {
+    const auto addresses = random_addresses(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        for (auto a : addresses) benchmark::DoNotOptimize(IP(a).to_string());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_Split)->RangeMultiplier(10)->Range(1'000, 100'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseInt)->RangeMultiplier(10)->Range(1'000, 100'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseOctet)->RangeMultiplier(10)->Range(1'000, 100'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MakeIp)->RangeMultiplier(10)->Range(1'000, 100'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ToString)->RangeMultiplier(10)->Range(1'000, 100'000'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "include/data_structs.hpp"
+#include "include/ingest.hpp"
+#include "include/prefix_index.hpp"
+#include "include/snapshot.hpp"
+
+namespace {
+
+constexpr std::size_t kSnapshotLines = 10'000'000;
+
+// the same pool once as TSV and once as a snapshot, in the working directory
+struct SnapshotFiles {
+    std::string tsv = "bench_snapshot.tsv";
+    std::string bin = "bench_snapshot.bin";
+
+    SnapshotFiles() {
+        std::mt19937 rng(21);
+        std::vector<CompactIP> pool;
+        {
+            std::ofstream out(tsv);
+            for (std::size_t i = 0; i < kSnapshotLines; ++i) {
+                pool.emplace_back(static_cast<std::uint32_t>(rng()));
+                out << pool.back().to_string() << "\t1\t1\n";
+            }
+        }
+
+        CompactIP::sort_reverse_lex(pool);
+        const PrefixIndex index(pool);
+        std::ofstream out(bin, std::ios::binary);
+        write_snapshot(out, pool, &index);
+    }
+};
+
+SnapshotFiles const &snapshot_files() {
+    static const SnapshotFiles files;
+    return files;
+}
+
+// what a run without a snapshot has to do before the first query
+void BM_StartupFromTsv(benchmark::State &state) {
+    auto const &files = snapshot_files();
+
+    for (auto _ : state) {
+        MappedFile file(files.tsv);
+        auto pool = parse_sorted_parallel(file.data(), 1);
+        PrefixIndex index(pool);
+        benchmark::DoNotOptimize(index.prefix(Cidr{0x2E460000, 16}).size());
+    }
+}
+
+void BM_StartupFromSnapshot(benchmark::State &state) {
+    auto const &files = snapshot_files();
+    const auto verify = state.range(0) != 0 ? Snapshot::Verify::Full : Snapshot::Verify::Layout;
+
+    for (auto _ : state) {
+        Snapshot snapshot(files.bin, verify);
+        auto index = snapshot.index();
+        benchmark::DoNotOptimize(index.prefix(Cidr{0x2E460000, 16}).size());
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_StartupFromTsv)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_StartupFromSnapshot)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
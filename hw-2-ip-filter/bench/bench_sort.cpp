@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "include/data_structs.hpp"
+
+namespace {
+
+std::vector<std::uint32_t> random_addresses(std::size_t n) {
+    std::mt19937 rng(12345);
+    std::vector<std::uint32_t> result(n);
+    std::ranges::generate(result, [&rng] { return static_cast<std::uint32_t>(rng()); });
+    return result;
+}
+
+template <typename Ip, typename Sort>
+void run_sort(benchmark::State &state, Sort sort) {
+    const auto addresses = random_addresses(static_cast<std::size_t>(state.range(0)));
+    std::vector<Ip> pool;
+    pool.reserve(addresses.size());
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        pool.clear();
+        for (auto a : addresses) pool.emplace_back(a);
+        state.ResumeTiming();
+
+        sort(pool);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["pool_bytes"] = static_cast<double>(pool.size() * sizeof(Ip));
+}
+
+void BM_SortIP(benchmark::State &state) {
+    run_sort<IP>(state, [](auto &pool) { IP::sort_reverse_lex(pool); });
+}
+
+void BM_SortCompactStd(benchmark::State &state) {
+    run_sort<CompactIP>(state, [](auto &pool) { std::ranges::sort(pool, std::greater<>{}); });
+}
+
+void BM_SortCompactRadix(benchmark::State &state) {
+    run_sort<CompactIP>(state, [](auto &pool) { CompactIP::sort_reverse_lex(pool); });
+}
+
+} // namespace
+
+BENCHMARK(BM_SortIP)->RangeMultiplier(8)->Range(1 << 10, 1 << 27)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortCompactStd)->RangeMultiplier(8)->Range(1 << 10, 1 << 27)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortCompactRadix)->RangeMultiplier(8)->Range(1 << 10, 1 << 27)->Unit(benchmark::kMillisecond);
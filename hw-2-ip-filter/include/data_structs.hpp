@@ -3,12 +3,19 @@
 #include <algorithm>
 #include <array>
 #include <expected>
+#include <functional>
 #include <ranges>
+#include <span>
 #include <compare>
+#include <cstddef>
 #include <cstdint>
+#include <iosfwd>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "include/radix_sort.hpp"
+
 enum ParseError {
     LengthError = 1,
     NotANumber
@@ -28,6 +35,7 @@ public:
     ~IP() = default;
 
     explicit IP(std::array<int, 4> ip);
+    explicit IP(std::uint32_t collapsed) noexcept;
 
     auto operator<=>(IP const&) const = default;
 
@@ -40,6 +48,7 @@ public:
     }
 
     [[nodiscard]] auto bytes() const noexcept { return split_ip_; }
+    [[nodiscard]] std::uint32_t collapsed() const noexcept { return collapsed_ip_; }
     [[nodiscard]] std::string to_string() const;
 
 private:
@@ -47,6 +56,122 @@ private:
     uint32_t collapsed_ip_;
 };
 
+// Compact IP: keeps only the collapsed address (4 bytes instead of 20),
+// octets are decoded on demand.
+class CompactIP {
+public:
+    CompactIP() = delete;
+    ~CompactIP() = default;
+
+    explicit constexpr CompactIP(std::uint32_t collapsed) noexcept : collapsed_ip_(collapsed) {}
+    explicit CompactIP(IP const &ip) noexcept : collapsed_ip_(ip.collapsed()) {}
+
+    auto operator<=>(CompactIP const&) const = default;
+
+    template <std::ranges::random_access_range Cont>
+    static void sort_reverse_lex(Cont& c) {
+        radix_sort_desc(c, [](CompactIP const& ip) { return ip.collapsed_ip_; });
+    }
+
+    [[nodiscard]] std::array<int, 4> bytes() const noexcept {
+        return {static_cast<int>(collapsed_ip_ >> 24),
+                static_cast<int>((collapsed_ip_ >> 16) & 0xFF),
+                static_cast<int>((collapsed_ip_ >> 8) & 0xFF),
+                static_cast<int>(collapsed_ip_ & 0xFF)};
+    }
+    [[nodiscard]] std::uint32_t collapsed() const noexcept { return collapsed_ip_; }
+    [[nodiscard]] std::string to_string() const;
+
+private:
+    std::uint32_t collapsed_ip_;
+};
+
+static_assert(sizeof(CompactIP) == sizeof(std::uint32_t));
+
+// Address stored as four big-endian bytes, e.g. inside a memory-mapped
+// snapshot. Read-only counterpart of CompactIP with the same accessors.
+class PackedIP {
+public:
+    PackedIP() = delete;
+    ~PackedIP() = default;
+
+    explicit constexpr PackedIP(std::uint32_t collapsed) noexcept
+        : octets_{static_cast<std::uint8_t>(collapsed >> 24), static_cast<std::uint8_t>(collapsed >> 16),
+                  static_cast<std::uint8_t>(collapsed >> 8), static_cast<std::uint8_t>(collapsed)} {}
+
+    [[nodiscard]] constexpr std::uint32_t collapsed() const noexcept {
+        return (std::uint32_t{octets_[0]} << 24) | (std::uint32_t{octets_[1]} << 16) |
+               (std::uint32_t{octets_[2]} << 8) | std::uint32_t{octets_[3]};
+    }
+    [[nodiscard]] std::array<int, 4> bytes() const noexcept { return {octets_[0], octets_[1], octets_[2], octets_[3]}; }
+    [[nodiscard]] std::string to_string() const { return CompactIP(collapsed()).to_string(); }
+
+private:
+    std::array<std::uint8_t, 4> octets_;
+};
+
+static_assert(sizeof(PackedIP) == 4 && alignof(PackedIP) == 1);
+
+// IPv6 address as two big-endian halves, so comparing (high, low) orders
+// addresses the same way as comparing their eight hextets one by one.
+class IP6 {
+public:
+    IP6() = delete;
+    ~IP6() = default;
+
+    constexpr IP6(std::uint64_t high, std::uint64_t low) noexcept : high_(high), low_(low) {}
+
+    auto operator<=>(IP6 const&) const = default;
+
+    // Radix sort on the high half, then each run of equal high halves on the
+    // low half. Cheaper than 16 LSD passes over 16-byte elements, since real
+    // pools share few long /64 prefixes and many short ones.
+    template <std::ranges::random_access_range Cont>
+    static void sort_reverse_lex(Cont& c) {
+        radix_sort_desc(c, [](IP6 const& ip) { return ip.high_; });
+
+        const auto first = std::ranges::begin(c);
+        const auto n = std::ranges::distance(c);
+        for (std::ranges::range_difference_t<Cont> begin = 0; begin < n;) {
+            auto end = begin + 1;
+            while (end < n && first[end].high_ == first[begin].high_) ++end;
+
+            auto run = std::ranges::subrange(first + begin, first + end);
+            if (end - begin > 256) {
+                radix_sort_desc(run, [](IP6 const& ip) { return ip.low_; });
+            } else if (end - begin > 1) {
+                std::ranges::sort(run, [](IP6 const& a, IP6 const& b) { return b.low_ < a.low_; });
+            }
+            begin = end;
+        }
+    }
+
+    [[nodiscard]] std::array<std::uint16_t, 8> hextets() const noexcept {
+        std::array<std::uint16_t, 8> result{};
+        for (std::size_t i = 0; i < 4; ++i) {
+            result[i] = static_cast<std::uint16_t>(high_ >> (48 - 16 * i));
+            result[i + 4] = static_cast<std::uint16_t>(low_ >> (48 - 16 * i));
+        }
+        return result;
+    }
+    [[nodiscard]] constexpr std::uint64_t high() const noexcept { return high_; }
+    [[nodiscard]] constexpr std::uint64_t low() const noexcept { return low_; }
+    [[nodiscard]] std::string to_string() const;
+
+private:
+    std::uint64_t high_;
+    std::uint64_t low_;
+};
+
+static_assert(sizeof(IP6) == 2 * sizeof(std::uint64_t));
+
+// Parses "2001:db8::1", "::", "::ffff:1.2.3.4" and friends. No zone ids, no brackets.
+std::expected<IP6, ParseError> parse_ip6(std::string_view str) noexcept;
+
+// Writes the RFC 5952 text of `ip` at `out` and returns the end.
+inline constexpr std::size_t kMaxIPv6TextLength = 39; // eight full hextets
+char *format_ipv6(IP6 ip, char *out) noexcept;
+
 inline std::expected<IP, ParseError> make_ip(auto &&split_ip) {
     // Convert the lazy split_view into a concrete vector of strings.
     auto string_octets = split_ip | std::ranges::to<std::vector<std::string>>();
@@ -73,3 +198,39 @@ inline std::expected<IP, ParseError> make_ip(auto &&split_ip) {
 
 
 std::vector<IP> parse_ip_from_pipe();
+
+// zero-allocation streaming parser
+//
+// Accepts exactly what parse_octet/make_ip accept, but works on string_views
+// over a block buffer and never touches the heap per line.
+inline constexpr std::size_t kParseBlockSize = 1 << 20;
+
+std::expected<int, ParseError> parse_octet_fast(std::string_view str) noexcept;
+
+std::expected<IP, ParseError> parse_ip_line(std::string_view line) noexcept;
+
+std::vector<IP> parse_ip_from_stream(std::istream &in, std::size_t block_size = kParseBlockSize);
+
+std::vector<CompactIP> parse_compact_ip_from_stream(std::istream &in, std::size_t block_size = kParseBlockSize);
+
+// Streams collapsed addresses to `sink` in small batches without keeping them.
+void parse_ip_batches(std::istream &in, std::function<void(std::span<std::uint32_t const>)> const &sink,
+                      std::size_t block_size = kParseBlockSize);
+
+// Parses a whole in-memory text (the last line may lack '\n') into `ip_pool`.
+void parse_compact_ip_block(std::string_view block, std::vector<CompactIP> &ip_pool);
+
+// mixed IPv4 / IPv6 input
+//
+// Lines whose first field is not a dotted quad are tried as IPv6, so the
+// IPv4 fast path is unchanged and both families come out of one pass.
+struct IPPools {
+    std::vector<CompactIP> ipv4;
+    std::vector<IP6> ipv6;
+
+    bool operator==(IPPools const &) const = default;
+};
+
+IPPools parse_ip_pools_from_stream(std::istream &in, std::size_t block_size = kParseBlockSize);
+
+void parse_ip_pools_block(std::string_view block, IPPools &pools);
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "include/data_structs.hpp"
+
+// Bounded-memory streaming modes: distinct addresses and heavy hitters.
+
+// Set of distinct addresses. Starts as a compact open-addressing table and
+// switches to a bitmap over the whole IPv4 space (512 MiB) once the table
+// would grow past 128 MiB. The bitmap is filled from the table before the
+// table is freed, so memory peaks at 640 MiB however long the input is. The
+// bitmap is calloc'ed, pages nobody writes stay unbacked.
+class UniqueAddressSet {
+public:
+    void insert(std::uint32_t address);
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool uses_bitmap() const noexcept { return bitmap_ != nullptr; }
+
+    // visits every distinct address once, in reverse-lex order
+    template <typename Visitor>
+    void visit_descending(Visitor &&visitor) const;
+
+private:
+    static constexpr std::size_t kBitmapWords = (std::size_t{1} << 32) / 64;
+    static constexpr std::size_t kMaxSlots = kBitmapWords * 64 / 32 / 4; // table a quarter of the bitmap
+    static constexpr std::size_t kInitialSlots = 1 << 12;
+
+    struct FreeDeleter {
+        void operator()(std::uint64_t *p) const noexcept { std::free(p); }
+    };
+
+    [[nodiscard]] std::size_t slot_of(std::uint32_t address) const noexcept {
+        // Fibonacci hashing onto the power-of-two table
+        const auto bits = std::countr_zero(slots_.size());
+        return static_cast<std::size_t>((std::uint64_t{address} * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+    }
+
+    bool insert_slot(std::uint32_t address) noexcept;
+    void grow();
+    void switch_to_bitmap();
+
+    std::vector<std::uint32_t> slots_; // 0 marks an empty slot, address 0 lives in has_zero_
+    bool has_zero_ = false;
+    std::size_t size_ = 0;
+    std::unique_ptr<std::uint64_t[], FreeDeleter> bitmap_;
+};
+
+template <typename Visitor>
+void UniqueAddressSet::visit_descending(Visitor &&visitor) const {
+    if (bitmap_) {
+        for (std::size_t word = kBitmapWords; word-- > 0;) {
+            for (auto bits = bitmap_[word]; bits != 0;) {
+                const int top = 63 - std::countl_zero(bits);
+                visitor(static_cast<std::uint32_t>(word * 64 + static_cast<std::size_t>(top)));
+                bits &= ~(std::uint64_t{1} << top);
+            }
+        }
+        return;
+    }
+
+    std::vector<std::uint32_t> addresses;
+    addresses.reserve(size_);
+    for (auto slot : slots_) {
+        if (slot != 0) addresses.push_back(slot);
+    }
+    if (has_zero_) addresses.push_back(0);
+
+    radix_sort_desc(addresses, [](std::uint32_t a) { return a; });
+    for (auto address : addresses) visitor(address);
+}
+
+
+struct AddressCount {
+    std::uint32_t address;
+    std::uint64_t count;
+    std::uint64_t error; // count may over-estimate by up to this much
+};
+
+// Heavy hitters with the Space-Saving algorithm: at most `capacity` counters,
+// kept in a min-heap on count. While the number of distinct addresses stays
+// within capacity every count is exact; past that the least frequent counter
+// is recycled and counts become upper bounds, see AddressCount::error.
+class TopKCounter {
+public:
+    static constexpr std::size_t kDefaultCapacity = 1 << 20;
+
+    explicit TopKCounter(std::size_t capacity = kDefaultCapacity);
+
+    void add(std::uint32_t address);
+
+    [[nodiscard]] bool exact() const noexcept { return exact_; }
+
+    // the k most frequent, by count and then in reverse-lex order
+    [[nodiscard]] std::vector<AddressCount> top(std::size_t k) const;
+
+private:
+    void sift_down(std::size_t i) noexcept;
+
+    std::size_t capacity_;
+    bool exact_ = true;
+    std::vector<AddressCount> heap_;
+    std::unordered_map<std::uint32_t, std::size_t> position_;
+};
+
+
+// "a.b.c.d\n" per distinct address, in reverse-lex order
+void write_unique(UniqueAddressSet const &unique, std::ostream &out);
+
+// "a.b.c.d\tcount\n" per entry
+void write_top(std::span<AddressCount const> top, std::ostream &out);
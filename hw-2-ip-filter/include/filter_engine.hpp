@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "include/data_structs.hpp"
+
+// Address predicate evaluated on the collapsed uint32 with byte masks.
+class AddressFilter {
+public:
+    // every address
+    static constexpr AddressFilter all() noexcept { return {Kind::Masked, 0, 0}; }
+
+    // (address & mask) == value, e.g. mask 0xFFFF0000 value 0x2E460000 for "46.70.*.*"
+    static constexpr AddressFilter masked(std::uint32_t mask, std::uint32_t value) noexcept {
+        return {Kind::Masked, mask, value & mask};
+    }
+
+    // leading `bits` bits equal those of `network` (CIDR prefix)
+    static constexpr AddressFilter prefix(std::uint32_t network, int bits) noexcept {
+        const std::uint32_t mask = bits <= 0 ? 0 : ~std::uint32_t{0} << (32 - std::min(bits, 32));
+        return masked(mask, network);
+    }
+
+    // any of the four octets equals `octet`
+    static constexpr AddressFilter any_octet(std::uint8_t octet) noexcept {
+        return {Kind::AnyOctet, 0, 0x01010101u * octet};
+    }
+
+    [[nodiscard]] constexpr bool operator()(std::uint32_t address) const noexcept {
+        if (kind_ == Kind::Masked) return (address & mask_) == value_;
+
+        // SWAR "has zero byte" on address ^ pattern
+        const std::uint32_t x = address ^ value_;
+        return ((x - 0x01010101u) & ~x & 0x80808080u) != 0;
+    }
+
+private:
+    enum class Kind : std::uint8_t { Masked, AnyOctet };
+
+    constexpr AddressFilter(Kind kind, std::uint32_t mask, std::uint32_t value) noexcept
+        : kind_(kind), mask_(mask), value_(value) {}
+
+    Kind kind_;
+    std::uint32_t mask_;
+    std::uint32_t value_;
+};
+
+// IPv6 counterpart of AddressFilter::prefix, one mask per half.
+class Address6Filter {
+public:
+    // every address
+    static constexpr Address6Filter all() noexcept { return prefix(IP6(0, 0), 0); }
+
+    // leading `bits` bits equal those of `network` (CIDR prefix, 0..128)
+    static constexpr Address6Filter prefix(IP6 network, int bits) noexcept {
+        const auto mask_of = [](int half_bits) -> std::uint64_t {
+            return half_bits <= 0 ? 0 : ~std::uint64_t{0} << (64 - std::min(half_bits, 64));
+        };
+        const std::uint64_t mask_high = mask_of(bits);
+        const std::uint64_t mask_low = mask_of(bits - 64);
+        return {mask_high, mask_low, network.high() & mask_high, network.low() & mask_low};
+    }
+
+    [[nodiscard]] constexpr bool operator()(IP6 address) const noexcept {
+        return ((address.high() & mask_high_) == value_high_) & ((address.low() & mask_low_) == value_low_);
+    }
+
+private:
+    constexpr Address6Filter(std::uint64_t mask_high, std::uint64_t mask_low,
+                             std::uint64_t value_high, std::uint64_t value_low) noexcept
+        : mask_high_(mask_high), mask_low_(mask_low), value_high_(value_high), value_low_(value_low) {}
+
+    std::uint64_t mask_high_;
+    std::uint64_t mask_low_;
+    std::uint64_t value_high_;
+    std::uint64_t value_low_;
+};
+
+// Evaluates N filters over a pool in one pass. Matches of filter i are
+// formatted into output buffer i, one address per line, in pool order.
+class FilterEngine {
+public:
+    explicit FilterEngine(std::vector<AddressFilter> filters);
+
+    void run(std::span<CompactIP const> ip_pool);
+    void run(std::span<PackedIP const> ip_pool);
+
+    [[nodiscard]] std::size_t size() const noexcept { return filters_.size(); }
+    [[nodiscard]] std::string_view output(std::size_t filter) const noexcept;
+
+    // all outputs, filter by filter, one write each
+    void write_to(std::ostream &out) const;
+
+private:
+    template <typename Ip>
+    void run_pool(std::span<Ip const> ip_pool);
+
+    struct Output {
+        std::unique_ptr<char[]> data;
+        std::size_t size = 0;
+    };
+
+    std::vector<AddressFilter> filters_;
+    std::vector<Output> outputs_;
+};
+
+// FilterEngine for IPv6 pools.
+class FilterEngine6 {
+public:
+    explicit FilterEngine6(std::vector<Address6Filter> filters);
+
+    void run(std::span<IP6 const> ip_pool);
+
+    [[nodiscard]] std::size_t size() const noexcept { return filters_.size(); }
+    [[nodiscard]] std::string_view output(std::size_t filter) const noexcept;
+
+    void write_to(std::ostream &out) const;
+
+private:
+    std::vector<Address6Filter> filters_;
+    std::vector<std::string> outputs_;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "include/data_structs.hpp"
+
+// Read-only view of a whole input file, memory-mapped where the platform
+// allows it and read into memory otherwise.
+class MappedFile {
+public:
+    explicit MappedFile(std::string const &path);
+    ~MappedFile();
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+
+    [[nodiscard]] std::string_view data() const noexcept { return {data_, size_}; }
+
+private:
+    char const *data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::string fallback_;
+};
+
+// Reads the rest of `in` into memory with large buffered reads.
+std::string read_all(std::istream &in, std::size_t block_size = kParseBlockSize);
+
+// Splits `data` into at most `parts` pieces that each end right after a '\n'
+// (the last one ends at the end of data). Empty pieces are dropped.
+std::vector<std::string_view> split_line_aligned(std::string_view data, std::size_t parts);
+
+// Merges runs that are each sorted in reverse-lex order, pairwise on up to `threads` threads.
+template <typename Ip>
+std::vector<Ip> merge_sorted_runs(std::vector<std::vector<Ip>> runs, unsigned threads) {
+    std::erase_if(runs, [](auto const &run) { return run.empty(); });
+    if (runs.empty()) return {};
+
+    threads = std::max(threads, 1u);
+    while (runs.size() > 1) {
+        std::vector<std::vector<Ip>> merged(runs.size() / 2);
+
+        // one round: run 2i and 2i+1 -> merged[i], at most `threads` merges at a time
+        for (std::size_t first = 0; first < merged.size(); first += threads) {
+            std::vector<std::jthread> workers;
+            for (std::size_t i = first; i < std::min(merged.size(), first + threads); ++i) {
+                workers.emplace_back([&runs, &merged, i] {
+                    auto &a = runs[2 * i];
+                    auto &b = runs[2 * i + 1];
+                    merged[i].reserve(a.size() + b.size());
+                    std::ranges::merge(a, b, std::back_inserter(merged[i]), std::greater<>{});
+                    std::vector<Ip>().swap(a);
+                    std::vector<Ip>().swap(b);
+                });
+            }
+        }
+
+        if (runs.size() % 2 != 0) merged.push_back(std::move(runs.back()));
+        runs = std::move(merged);
+    }
+
+    return std::move(runs.front());
+}
+
+// Parses newline-aligned chunks of `data` on `threads` threads, sorts each
+// chunk locally and merges the results. Same pool as the sequential
+// parse_compact_ip_block() + CompactIP::sort_reverse_lex().
+std::vector<CompactIP> parse_sorted_parallel(std::string_view data, unsigned threads);
+
+// Same for mixed input: both families are split off in one pass over each
+// chunk, then sorted and merged independently.
+IPPools parse_ip_pools_parallel(std::string_view data, unsigned threads);
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <string_view>
+
+#include "include/data_structs.hpp"
+
+// Dotted-quad decoders producing the collapsed (big-endian order) address.
+//
+// All of them accept exactly what make_ip(split(field, '.')) accepts and
+// report the same ParseError. The SIMD kernel only handles the canonical
+// "d{1,3}.d{1,3}.d{1,3}.d{1,3}" layout itself and hands everything else
+// (signs, whitespace, long zero-padded octets, garbage) to the scalar one.
+
+std::expected<std::uint32_t, ParseError> decode_ipv4_scalar(std::string_view field) noexcept;
+
+// Only usable when has_sse41_decoder() is true.
+std::expected<std::uint32_t, ParseError> decode_ipv4_sse41(std::string_view field) noexcept;
+
+[[nodiscard]] bool has_sse41_decoder() noexcept;
+
+// Picks the best kernel for the running CPU once, on first use.
+std::expected<std::uint32_t, ParseError> decode_ipv4(std::string_view field) noexcept;
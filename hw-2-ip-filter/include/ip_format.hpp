@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+// Dotted-quad formatting without iostreams.
+
+struct OctetText {
+    std::array<char, 3> text;
+    std::uint8_t length;
+};
+
+// decimal text of every octet value
+inline constexpr auto kOctetText = [] {
+    std::array<OctetText, 256> table{};
+    for (int value = 0; value < 256; ++value) {
+        auto &entry = table[static_cast<std::size_t>(value)];
+        if (value >= 100) {
+            entry = {{static_cast<char>('0' + value / 100), static_cast<char>('0' + value / 10 % 10),
+                      static_cast<char>('0' + value % 10)}, 3};
+        } else if (value >= 10) {
+            entry = {{static_cast<char>('0' + value / 10), static_cast<char>('0' + value % 10), '\0'}, 2};
+        } else {
+            entry = {{static_cast<char>('0' + value), '\0', '\0'}, 1};
+        }
+    }
+    return table;
+}();
+
+inline constexpr std::size_t kMaxIPv4TextLength = 15; // "255.255.255.255"
+
+// Writes "a.b.c.d" at `out` and returns the end. Always stores 16 bytes, so
+// `out` must have that much room even though at most 15 are meaningful.
+inline char *format_ipv4(std::uint32_t collapsed, char *out) noexcept {
+    char scratch[4 * 4] = {};
+    char *cursor = scratch;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        auto const &octet = kOctetText[(collapsed >> shift) & 0xFF];
+        std::memcpy(cursor, octet.text.data(), 3);
+        cursor += octet.length;
+        *cursor++ = '.';
+    }
+
+    std::memcpy(out, scratch, sizeof(scratch));
+    return out + (cursor - scratch - 1);
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "include/data_structs.hpp"
+
+// "a.b.c.d/len" (a bare address means /32)
+struct Cidr {
+    std::uint32_t network;
+    int bits;
+
+    [[nodiscard]] constexpr std::uint32_t mask() const noexcept {
+        return bits <= 0 ? 0 : ~std::uint32_t{0} << (32 - bits);
+    }
+};
+
+std::expected<Cidr, ParseError> parse_cidr(std::string_view text) noexcept;
+
+// Query index over a pool sorted by CompactIP::sort_reverse_lex. Does not own
+// the pool, which must outlive it. `Ip` is CompactIP for in-memory pools and
+// PackedIP for memory-mapped snapshots.
+//
+// A 65,537-entry table of bucket boundaries keyed by the top 16 bits turns
+// any prefix of up to 16 bits into an O(1) span lookup; longer prefixes
+// binary-search inside their /16 bucket. Every bucket also keeps a 256-bit
+// set of the octet values found in its low 16 bits, so "any octet == x"
+// skips the buckets that cannot match.
+template <typename Ip>
+class BasicPrefixIndex {
+public:
+    static constexpr std::size_t kBuckets = 1u << 16;
+
+    using Boundaries = std::vector<std::uint64_t>;               // kBuckets + 1 entries
+    using OctetSets = std::vector<std::array<std::uint64_t, 4>>; // kBuckets entries
+
+    explicit BasicPrefixIndex(std::span<Ip const> sorted_pool);
+
+    // reuses tables saved earlier, see boundaries() and low_octets()
+    BasicPrefixIndex(std::span<Ip const> sorted_pool, Boundaries boundaries, OctetSets low_octets);
+
+    [[nodiscard]] std::span<Ip const> pool() const noexcept { return pool_; }
+
+    // contiguous run of addresses inside `cidr`, in pool order
+    [[nodiscard]] std::span<Ip const> prefix(Cidr cidr) const noexcept;
+
+    // calls visitor(std::span<Ip const>) for every run of addresses having
+    // `octet` in any position, in pool order
+    template <typename Visitor>
+    void visit_any_octet(std::uint8_t octet, Visitor &&visitor) const;
+
+    // addresses whose top 16 bits are h occupy [boundaries()[h + 1], boundaries()[h])
+    [[nodiscard]] Boundaries const &boundaries() const noexcept { return at_least_; }
+    [[nodiscard]] OctetSets const &low_octets() const noexcept { return low_octets_; }
+
+private:
+    [[nodiscard]] std::span<Ip const> bucket(std::size_t top16) const noexcept {
+        return pool_.subspan(at_least_[top16 + 1], at_least_[top16] - at_least_[top16 + 1]);
+    }
+
+    [[nodiscard]] bool bucket_has_low_octet(std::size_t top16, std::uint8_t octet) const noexcept {
+        return (low_octets_[top16][octet / 64] >> (octet % 64)) & 1u;
+    }
+
+    std::span<Ip const> pool_;
+    Boundaries at_least_;
+    OctetSets low_octets_;
+};
+
+using PrefixIndex = BasicPrefixIndex<CompactIP>;
+
+
+template <typename Ip>
+BasicPrefixIndex<Ip>::BasicPrefixIndex(std::span<Ip const> sorted_pool)
+    : pool_(sorted_pool), at_least_(kBuckets + 1, 0), low_octets_(kBuckets) {
+    // at_least_[h] = number of addresses whose top 16 bits are >= h
+    std::size_t position = 0;
+    for (std::size_t top16 = kBuckets; top16-- > 0;) {
+        while (position < pool_.size() && (pool_[position].collapsed() >> 16) >= top16) ++position;
+        at_least_[top16] = position;
+    }
+
+    for (auto const &ip : pool_) {
+        const auto address = ip.collapsed();
+        auto &octets = low_octets_[address >> 16];
+
+        for (std::uint32_t octet : {(address >> 8) & 0xFF, address & 0xFF}) {
+            octets[octet / 64] |= std::uint64_t{1} << (octet % 64);
+        }
+    }
+}
+
+template <typename Ip>
+BasicPrefixIndex<Ip>::BasicPrefixIndex(std::span<Ip const> sorted_pool, Boundaries boundaries, OctetSets low_octets)
+    : pool_(sorted_pool), at_least_(std::move(boundaries)), low_octets_(std::move(low_octets)) {
+    if (at_least_.size() != kBuckets + 1 || at_least_.front() != pool_.size() || at_least_.back() != 0 ||
+        low_octets_.size() != kBuckets) {
+        throw std::invalid_argument("prefix index tables do not match the pool");
+    }
+}
+
+template <typename Ip>
+std::span<Ip const> BasicPrefixIndex<Ip>::prefix(Cidr cidr) const noexcept {
+    const auto mask = cidr.mask();
+    const auto network = cidr.network & mask;
+
+    // every /16 bucket under the prefix is adjacent in the pool
+    const std::size_t low = network >> 16;
+    const std::size_t high = (network | ~mask) >> 16;
+    auto run = pool_.subspan(at_least_[high + 1], at_least_[low] - at_least_[high + 1]);
+
+    if (cidr.bits <= 16) return run;
+
+    auto masked = [mask](Ip const &ip) { return ip.collapsed() & mask; };
+    auto [first, last] = std::ranges::equal_range(run, network, std::greater<>{}, masked);
+    return {first, last};
+}
+
+template <typename Ip>
+template <typename Visitor>
+void BasicPrefixIndex<Ip>::visit_any_octet(std::uint8_t octet, Visitor &&visitor) const {
+    // the pool is descending, so is the bucket order
+    for (std::size_t top16 = kBuckets; top16-- > 0;) {
+        const auto run = bucket(top16);
+        if (run.empty()) continue;
+
+        if ((top16 >> 8) == octet || (top16 & 0xFF) == octet) {
+            visitor(run);
+            continue;
+        }
+        if (!bucket_has_low_octet(top16, octet)) continue;
+
+        auto matches = [&run, octet](std::size_t i) {
+            const auto address = run[i].collapsed();
+            return ((address >> 8) & 0xFF) == octet || (address & 0xFF) == octet;
+        };
+
+        for (std::size_t i = 0; i < run.size();) {
+            while (i < run.size() && !matches(i)) ++i;
+            const auto begin = i;
+            while (i < run.size() && matches(i)) ++i;
+            if (i > begin) visitor(run.subspan(begin, i - begin));
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// LSD radix sort in descending key order, 8 bits per pass.
+//
+// `key` maps an element to an unsigned integer. The sort is stable, so wider
+// keys can be sorted by calling it on the low part first and on the high part
+// last. Passes in which every element has the same digit are skipped. Needs
+// one scratch copy of the range.
+template <std::ranges::random_access_range Cont, typename Key>
+    requires std::unsigned_integral<std::invoke_result_t<Key &, std::ranges::range_reference_t<Cont>>>
+void radix_sort_desc(Cont &c, Key key) {
+    using Value = std::ranges::range_value_t<Cont>;
+    using KeyType = std::invoke_result_t<Key &, std::ranges::range_reference_t<Cont>>;
+    constexpr std::size_t passes = sizeof(KeyType);
+
+    const auto first = std::ranges::begin(c);
+    const auto n = static_cast<std::size_t>(std::ranges::distance(c));
+    if (n < 2) return;
+
+    auto digit_of = [&key](auto const &element, std::size_t pass) {
+        return static_cast<std::size_t>((key(element) >> (8 * pass)) & 0xFF);
+    };
+
+    std::array<std::array<std::size_t, 256>, passes> counts{};
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            ++counts[pass][digit_of(first[i], pass)];
+        }
+    }
+
+    std::vector<Value> buffer(first, std::ranges::end(c));
+    bool in_buffer = false;
+
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        auto const &count = counts[pass];
+        if (std::ranges::find(count, n) != count.end()) continue;
+
+        // descending: the highest digit goes first
+        std::array<std::size_t, 256> offset{};
+        std::size_t running = 0;
+        for (std::size_t digit = 256; digit-- > 0;) {
+            offset[digit] = running;
+            running += count[digit];
+        }
+
+        if (in_buffer) {
+            for (auto &element : buffer) first[offset[digit_of(element, pass)]++] = std::move(element);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) buffer[offset[digit_of(first[i], pass)]++] = std::move(first[i]);
+        }
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) std::ranges::move(buffer, first);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "include/data_structs.hpp"
+#include "include/ingest.hpp"
+#include "include/prefix_index.hpp"
+
+// Versioned binary snapshot of a sorted pool, so that later runs can mmap it
+// instead of parsing TSV again. All integers are big-endian:
+//
+//   0   magic "IPFSNAP\n"
+//   8   u32 format version (kSnapshotVersion)
+//   12  u32 flags (kSnapshotHasIndex: prefix index tables follow the pool)
+//   16  u64 address count
+//   24  u64 FNV-1a of the address section
+//   32  u64 FNV-1a of the index section (0 without one)
+//   40  reserved up to 64
+//   64  addresses, 4 bytes each, in CompactIP::sort_reverse_lex order
+//   ..  optional: PrefixIndex boundaries (65,537 x u64), then its per-bucket
+//       low-octet sets (65,536 x 4 x u64)
+
+inline constexpr std::string_view kSnapshotMagic{"IPFSNAP\n", 8};
+inline constexpr std::uint32_t kSnapshotVersion = 1;
+inline constexpr std::uint32_t kSnapshotHasIndex = 1;
+inline constexpr std::size_t kSnapshotHeaderSize = 64;
+
+// Writes `sorted_pool`, plus the tables of `index` when given.
+void write_snapshot(std::ostream &out, std::span<CompactIP const> sorted_pool, PrefixIndex const *index = nullptr);
+
+// true if the file starts with the snapshot magic
+bool is_snapshot_file(std::string const &path);
+
+// Memory-mapped snapshot; addresses are used in place, without a copy.
+// Throws std::runtime_error on malformed or mismatching files.
+class Snapshot {
+public:
+    enum class Verify {
+        Layout, // header, sizes and index checksum (cheap, the default)
+        Full    // also checksum every address
+    };
+
+    explicit Snapshot(std::string const &path, Verify verify = Verify::Layout);
+
+    [[nodiscard]] std::span<PackedIP const> pool() const noexcept { return pool_; }
+    [[nodiscard]] bool has_index() const noexcept { return !index_section_.empty(); }
+
+    // from the stored tables when present, built over the pool otherwise
+    [[nodiscard]] BasicPrefixIndex<PackedIP> index() const;
+
+private:
+    MappedFile file_;
+    std::span<PackedIP const> pool_;
+    std::string_view index_section_;
+};
@@ -0,0 +1,179 @@
+#include "include/dedup.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <new>
+#include <ostream>
+#include <string>
+
+#include "include/ip_format.hpp"
+
+// UniqueAddressSet implementation
+void UniqueAddressSet::insert(std::uint32_t address) {
+    if (bitmap_) {
+        auto &word = bitmap_[address / 64];
+        const auto bit = std::uint64_t{1} << (address % 64);
+        size_ += (word & bit) == 0;
+        word |= bit;
+        return;
+    }
+
+    if (address == 0) {
+        size_ += !has_zero_;
+        has_zero_ = true;
+        return;
+    }
+
+    // keep the load factor at or below 1/2
+    if (2 * (size_ + 1) > slots_.size()) grow();
+    if (bitmap_) {
+        insert(address);
+        return;
+    }
+
+    size_ += insert_slot(address);
+}
+
+bool UniqueAddressSet::insert_slot(std::uint32_t address) noexcept {
+    const auto mask = slots_.size() - 1;
+    for (auto slot = slot_of(address);; slot = (slot + 1) & mask) {
+        if (slots_[slot] == address) return false;
+        if (slots_[slot] == 0) {
+            slots_[slot] = address;
+            return true;
+        }
+    }
+}
+
+void UniqueAddressSet::grow() {
+    const auto slots = slots_.empty() ? kInitialSlots : slots_.size() * 2;
+    if (slots > kMaxSlots) {
+        switch_to_bitmap();
+        return;
+    }
+
+    auto old = std::move(slots_);
+    slots_.assign(slots, 0);
+    for (auto address : old) {
+        if (address != 0) insert_slot(address);
+    }
+}
+
+void UniqueAddressSet::switch_to_bitmap() {
+    bitmap_.reset(static_cast<std::uint64_t *>(std::calloc(kBitmapWords, sizeof(std::uint64_t))));
+    if (!bitmap_) throw std::bad_alloc();
+
+    for (auto address : slots_) {
+        if (address != 0) bitmap_[address / 64] |= std::uint64_t{1} << (address % 64);
+    }
+    if (has_zero_) bitmap_[0] |= 1;
+
+    std::vector<std::uint32_t>().swap(slots_);
+}
+
+
+// TopKCounter implementation
+TopKCounter::TopKCounter(std::size_t capacity) : capacity_(std::max<std::size_t>(capacity, 1)) {
+    heap_.reserve(capacity_);
+    position_.reserve(capacity_);
+}
+
+void TopKCounter::add(std::uint32_t address) {
+    if (auto it = position_.find(address); it != position_.end()) {
+        ++heap_[it->second].count;
+        sift_down(it->second);
+        return;
+    }
+
+    if (heap_.size() < capacity_) {
+        // a new counter of 1 is never above its parent, no sift needed
+        heap_.push_back({address, 1, 0});
+        position_.emplace(address, heap_.size() - 1);
+        return;
+    }
+
+    // recycle the least frequent counter
+    exact_ = false;
+    auto &victim = heap_.front();
+    position_.erase(victim.address);
+    victim = {address, victim.count + 1, victim.count};
+    position_.emplace(address, 0);
+    sift_down(0);
+}
+
+void TopKCounter::sift_down(std::size_t i) noexcept {
+    const auto n = heap_.size();
+    while (true) {
+        auto smallest = i;
+        for (auto child : {2 * i + 1, 2 * i + 2}) {
+            if (child < n && heap_[child].count < heap_[smallest].count) smallest = child;
+        }
+        if (smallest == i) return;
+
+        std::swap(heap_[i], heap_[smallest]);
+        position_[heap_[i].address] = i;
+        position_[heap_[smallest].address] = smallest;
+        i = smallest;
+    }
+}
+
+std::vector<AddressCount> TopKCounter::top(std::size_t k) const {
+    std::vector<AddressCount> result(std::min(k, heap_.size()));
+    std::ranges::partial_sort_copy(heap_, result, [](AddressCount const &a, AddressCount const &b) {
+        return a.count != b.count ? a.count > b.count : a.address > b.address;
+    });
+    return result;
+}
+
+
+namespace {
+
+// formats into one large block and writes it whenever it fills up
+class BlockWriter {
+public:
+    explicit BlockWriter(std::ostream &out) : out_(out) { block_.reserve(kBlock + 64); }
+    ~BlockWriter() { flush(); }
+
+    char *reserve(std::size_t bytes) {
+        if (block_.size() + bytes > kBlock) flush();
+        const auto size = block_.size();
+        block_.resize(size + bytes);
+        return block_.data() + size;
+    }
+
+    void commit(char *end) { block_.resize(static_cast<std::size_t>(end - block_.data())); }
+
+    void flush() {
+        out_.write(block_.data(), static_cast<std::streamsize>(block_.size()));
+        block_.clear();
+    }
+
+private:
+    static constexpr std::size_t kBlock = 1 << 20;
+
+    std::ostream &out_;
+    std::string block_;
+};
+
+} // namespace
+
+void write_unique(UniqueAddressSet const &unique, std::ostream &out) {
+    BlockWriter writer(out);
+    unique.visit_descending([&writer](std::uint32_t address) {
+        char *end = format_ipv4(address, writer.reserve(kMaxIPv4TextLength + 1));
+        *end++ = '\n';
+        writer.commit(end);
+    });
+}
+
+void write_top(std::span<AddressCount const> top, std::ostream &out) {
+    BlockWriter writer(out);
+    for (auto const &entry : top) {
+        char *cursor = writer.reserve(kMaxIPv4TextLength + 1 + 21 + 1);
+        char *end = format_ipv4(entry.address, cursor);
+        *end++ = '\t';
+        end = std::to_chars(end, end + 21, entry.count).ptr;
+        *end++ = '\n';
+        writer.commit(end);
+    }
+}
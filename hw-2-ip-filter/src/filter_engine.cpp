@@ -0,0 +1,100 @@
+#include "include/filter_engine.hpp"
+
+#include <cstring>
+#include <ostream>
+
+#include "include/ip_format.hpp"
+
+FilterEngine::FilterEngine(std::vector<AddressFilter> filters)
+    : filters_(std::move(filters)), outputs_(filters_.size()) {
+}
+
+void FilterEngine::run(std::span<CompactIP const> ip_pool) {
+    run_pool(ip_pool);
+}
+
+void FilterEngine::run(std::span<PackedIP const> ip_pool) {
+    run_pool(ip_pool);
+}
+
+template <typename Ip>
+void FilterEngine::run_pool(std::span<Ip const> ip_pool) {
+    // worst case every address matches; untouched tail pages are never faulted in
+    const std::size_t capacity = ip_pool.size() * (kMaxIPv4TextLength + 1) + 16;
+
+    std::vector<char *> cursors;
+    cursors.reserve(filters_.size());
+    for (auto &output : outputs_) {
+        output.data = std::make_unique_for_overwrite<char[]>(capacity);
+        cursors.push_back(output.data.get());
+    }
+
+    char line[32];
+    for (auto const &ip : ip_pool) {
+        const auto address = ip.collapsed();
+
+        std::size_t length = 0;
+        for (std::size_t i = 0; i < filters_.size(); ++i) {
+            if (!filters_[i](address)) continue;
+
+            if (length == 0) {
+                char *end = format_ipv4(address, line);
+                *end++ = '\n';
+                length = static_cast<std::size_t>(end - line);
+            }
+
+            std::memcpy(cursors[i], line, 16);
+            cursors[i] += length;
+        }
+    }
+
+    for (std::size_t i = 0; i < outputs_.size(); ++i) {
+        outputs_[i].size = static_cast<std::size_t>(cursors[i] - outputs_[i].data.get());
+    }
+}
+
+std::string_view FilterEngine::output(std::size_t filter) const noexcept {
+    auto const &output = outputs_[filter];
+    return {output.data.get(), output.size};
+}
+
+void FilterEngine::write_to(std::ostream &out) const {
+    for (std::size_t i = 0; i < outputs_.size(); ++i) {
+        const auto text = output(i);
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+}
+
+
+// FilterEngine6 implementation
+FilterEngine6::FilterEngine6(std::vector<Address6Filter> filters)
+    : filters_(std::move(filters)), outputs_(filters_.size()) {
+}
+
+void FilterEngine6::run(std::span<IP6 const> ip_pool) {
+    for (auto &output : outputs_) output.clear();
+
+    char line[kMaxIPv6TextLength + 1];
+    for (auto const &ip : ip_pool) {
+        std::size_t length = 0;
+        for (std::size_t i = 0; i < filters_.size(); ++i) {
+            if (!filters_[i](ip)) continue;
+
+            if (length == 0) {
+                char *end = format_ipv6(ip, line);
+                *end++ = '\n';
+                length = static_cast<std::size_t>(end - line);
+            }
+
+            outputs_[i].append(line, length);
+        }
+    }
+}
+
+std::string_view FilterEngine6::output(std::size_t filter) const noexcept {
+    return outputs_[filter];
+}
+
+void FilterEngine6::write_to(std::ostream &out) const {
+    for (auto const &output : outputs_) out.write(output.data(), static_cast<std::streamsize>(output.size()));
+}
@@ -0,0 +1,137 @@
+#include "include/ingest.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+
+#if __has_include(<sys/mman.h>)
+#define IP_FILTER_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+// MappedFile implementation
+MappedFile::MappedFile(std::string const &path) {
+#ifdef IP_FILTER_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + path);
+
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *mem = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mem != MAP_FAILED) {
+            ::madvise(mem, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+            data_ = static_cast<char const *>(mem);
+            size_ = static_cast<std::size_t>(st.st_size);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+
+    if (mapped_) return;
+    spdlog::debug("mmap unavailable for {}, reading it instead", path);
+#endif
+
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) throw std::runtime_error("cannot open " + path);
+
+    fallback_ = read_all(ifs);
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+}
+
+MappedFile::~MappedFile() {
+#ifdef IP_FILTER_HAS_MMAP
+    if (mapped_) ::munmap(const_cast<char *>(data_), size_);
+#endif
+}
+
+
+std::string read_all(std::istream &in, std::size_t block_size) {
+    std::string data;
+    auto *source = in.rdbuf();
+
+    for (std::size_t filled = 0;;) {
+        data.resize(filled + std::max<std::size_t>(block_size, 1));
+        const auto got = source->sgetn(data.data() + filled, static_cast<std::streamsize>(data.size() - filled));
+        if (got <= 0) {
+            data.resize(filled);
+            break;
+        }
+        filled += static_cast<std::size_t>(got);
+    }
+
+    in.setstate(std::ios::eofbit);
+    return data;
+}
+
+std::vector<std::string_view> split_line_aligned(std::string_view data, std::size_t parts) {
+    std::vector<std::string_view> chunks;
+    parts = std::max<std::size_t>(parts, 1);
+
+    std::size_t begin = 0;
+    for (std::size_t part = 1; part <= parts && begin < data.size(); ++part) {
+        std::size_t end = data.size();
+        if (part < parts) {
+            const auto eol = data.find('\n', std::max(begin, data.size() / parts * part));
+            if (eol != std::string_view::npos) end = eol + 1;
+        }
+
+        chunks.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+
+    return chunks;
+}
+
+std::vector<CompactIP> parse_sorted_parallel(std::string_view data, unsigned threads) {
+    threads = std::max(threads, 1u);
+    const auto chunks = split_line_aligned(data, threads);
+
+    std::vector<std::vector<CompactIP>> runs(chunks.size());
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&chunks, &runs, i] {
+                parse_compact_ip_block(chunks[i], runs[i]);
+                CompactIP::sort_reverse_lex(runs[i]);
+            });
+        }
+    }
+
+    return merge_sorted_runs(std::move(runs), threads);
+}
+
+IPPools parse_ip_pools_parallel(std::string_view data, unsigned threads) {
+    threads = std::max(threads, 1u);
+    const auto chunks = split_line_aligned(data, threads);
+
+    std::vector<IPPools> runs(chunks.size());
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&chunks, &runs, i] {
+                parse_ip_pools_block(chunks[i], runs[i]);
+                CompactIP::sort_reverse_lex(runs[i].ipv4);
+                IP6::sort_reverse_lex(runs[i].ipv6);
+            });
+        }
+    }
+
+    std::vector<std::vector<CompactIP>> ipv4_runs;
+    std::vector<std::vector<IP6>> ipv6_runs;
+    for (auto &run : runs) {
+        ipv4_runs.push_back(std::move(run.ipv4));
+        ipv6_runs.push_back(std::move(run.ipv6));
+    }
+
+    IPPools pools;
+    pools.ipv4 = merge_sorted_runs(std::move(ipv4_runs), threads);
+    pools.ipv6 = merge_sorted_runs(std::move(ipv6_runs), threads);
+    return pools;
+}
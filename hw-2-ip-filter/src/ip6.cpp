@@ -0,0 +1,168 @@
+#include "include/data_structs.hpp"
+#include "include/ip_format.hpp"
+
+#include <array>
+#include <cstring>
+#include <string>
+
+namespace {
+
+// value of a hex digit, 0xFF for anything else
+constexpr auto kHexValue = [] {
+    std::array<std::uint8_t, 256> table{};
+    table.fill(0xFF);
+    for (int c = '0'; c <= '9'; ++c) table[static_cast<std::size_t>(c)] = static_cast<std::uint8_t>(c - '0');
+    for (int c = 'a'; c <= 'f'; ++c) table[static_cast<std::size_t>(c)] = static_cast<std::uint8_t>(c - 'a' + 10);
+    for (int c = 'A'; c <= 'F'; ++c) table[static_cast<std::size_t>(c)] = static_cast<std::uint8_t>(c - 'A' + 10);
+    return table;
+}();
+
+constexpr std::uint8_t hex_value(char c) noexcept {
+    return kHexValue[static_cast<unsigned char>(c)];
+}
+
+// strict "d{1,3}.d{1,3}.d{1,3}.d{1,3}" for the embedded IPv4 tail
+std::expected<std::uint32_t, ParseError> parse_ipv4_tail(std::string_view str) noexcept {
+    std::uint32_t collapsed = 0;
+    std::size_t pos = 0;
+    for (int octet = 0; octet < 4; ++octet) {
+        if (octet != 0) {
+            if (pos == str.size() || str[pos] != '.') return std::unexpected(ParseError::LengthError);
+            ++pos;
+        }
+
+        const std::size_t start = pos;
+        std::uint32_t value = 0;
+        while (pos < str.size() && pos - start < 3 && str[pos] >= '0' && str[pos] <= '9') {
+            value = value * 10 + static_cast<std::uint32_t>(str[pos++] - '0');
+        }
+        if (pos == start || value > 255) return std::unexpected(ParseError::NotANumber);
+
+        collapsed = (collapsed << 8) | value;
+    }
+
+    if (pos != str.size()) return std::unexpected(ParseError::NotANumber);
+    return collapsed;
+}
+
+} // namespace
+
+std::expected<IP6, ParseError> parse_ip6(std::string_view str) noexcept {
+    constexpr std::size_t kNoGap = 9; // outside 0..8, where a "::" can stand
+
+    std::array<std::uint16_t, 8> groups{};
+    std::size_t count = 0;
+    std::size_t gap = kNoGap; // index of the group the "::" stands in front of
+    std::size_t pos = 0;
+
+    if (str.starts_with("::")) {
+        gap = 0;
+        pos = 2;
+    } else if (str.starts_with(':')) {
+        return std::unexpected(ParseError::NotANumber);
+    }
+
+    while (pos < str.size()) {
+        if (count == 8) return std::unexpected(ParseError::LengthError);
+
+        const std::size_t start = pos;
+        std::uint32_t value = 0;
+        while (pos < str.size() && hex_value(str[pos]) != 0xFF) {
+            value = (value << 4) | hex_value(str[pos++]);
+            if (pos - start > 4) return std::unexpected(ParseError::NotANumber);
+        }
+
+        if (pos < str.size() && str[pos] == '.') {
+            // dotted IPv4 in the last two groups
+            if (count > 6) return std::unexpected(ParseError::LengthError);
+            auto tail = parse_ipv4_tail(str.substr(start));
+            if (!tail) return std::unexpected(tail.error());
+
+            groups[count++] = static_cast<std::uint16_t>(*tail >> 16);
+            groups[count++] = static_cast<std::uint16_t>(*tail);
+            break;
+        }
+
+        if (pos == start) return std::unexpected(ParseError::NotANumber);
+        groups[count++] = static_cast<std::uint16_t>(value);
+
+        if (pos == str.size()) break;
+        if (str[pos++] != ':') return std::unexpected(ParseError::NotANumber);
+
+        if (pos < str.size() && str[pos] == ':') {
+            if (gap != kNoGap) return std::unexpected(ParseError::NotANumber);
+            gap = count;
+            ++pos;
+        } else if (pos == str.size()) {
+            return std::unexpected(ParseError::NotANumber); // trailing single ':'
+        }
+    }
+
+    if (gap == kNoGap ? count != 8 : count > 7) return std::unexpected(ParseError::LengthError);
+
+    if (gap != kNoGap) {
+        // move the groups after "::" to the end, zeros in between
+        const std::size_t tail = count - gap;
+        std::memmove(groups.data() + 8 - tail, groups.data() + gap, tail * sizeof(std::uint16_t));
+        std::fill(groups.begin() + static_cast<std::ptrdiff_t>(gap),
+                  groups.begin() + static_cast<std::ptrdiff_t>(8 - tail), std::uint16_t{0});
+    }
+
+    std::uint64_t high = 0;
+    std::uint64_t low = 0;
+    for (std::size_t i = 0; i < 4; ++i) {
+        high = (high << 16) | groups[i];
+        low = (low << 16) | groups[i + 4];
+    }
+
+    return IP6(high, low);
+}
+
+char *format_ipv6(IP6 ip, char *out) noexcept {
+    // RFC 5952 section 5: IPv4-mapped addresses keep the dotted tail
+    if (ip.high() == 0 && (ip.low() >> 32) == 0xFFFF) {
+        std::memcpy(out, "::ffff:", 7);
+        char tail[kMaxIPv4TextLength + 1];
+        const char *end = format_ipv4(static_cast<std::uint32_t>(ip.low()), tail);
+        std::memcpy(out + 7, tail, static_cast<std::size_t>(end - tail));
+        return out + 7 + (end - tail);
+    }
+
+    const auto groups = ip.hextets();
+
+    // longest run of two or more zero groups, the first one on ties
+    std::size_t best = 8;
+    std::size_t best_length = 1;
+    for (std::size_t i = 0; i < 8;) {
+        std::size_t end = i;
+        while (end < 8 && groups[end] == 0) ++end;
+        if (end - i > best_length) {
+            best = i;
+            best_length = end - i;
+        }
+        i = end == i ? i + 1 : end;
+    }
+
+    constexpr char kDigits[] = "0123456789abcdef";
+    for (std::size_t i = 0; i < 8; ++i) {
+        if (i == best) {
+            *out++ = ':';
+            *out++ = ':';
+            i += best_length - 1;
+            continue;
+        }
+        if (i != 0 && i != best + best_length) *out++ = ':';
+
+        const unsigned group = groups[i];
+        int shift = 12;
+        while (shift > 0 && (group >> shift) == 0) shift -= 4;
+        for (; shift >= 0; shift -= 4) *out++ = kDigits[(group >> shift) & 0xF];
+    }
+
+    return out;
+}
+
+std::string IP6::to_string() const {
+    char text[kMaxIPv6TextLength];
+    return {text, format_ipv6(*this, text)};
+}
@@ -0,0 +1,140 @@
+#include "include/ip_decode.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define IP_FILTER_HAS_SSE41_KERNEL 1
+#include <immintrin.h>
+#endif
+
+std::expected<std::uint32_t, ParseError> decode_ipv4_scalar(std::string_view field) noexcept {
+    // make_ip checks the number of parts before looking at any of them
+    if (std::ranges::count(field, '.') != 3) {
+        return std::unexpected(ParseError::LengthError);
+    }
+
+    std::uint32_t collapsed = 0;
+    std::size_t begin = 0;
+    for (std::size_t index = 0; index < 4; ++index) {
+        const auto dot = field.find('.', begin);
+        auto octet = parse_octet_fast(field.substr(begin, dot == std::string_view::npos ? dot : dot - begin));
+        if (!octet) return std::unexpected(ParseError::NotANumber);
+
+        collapsed = (collapsed << 8) | static_cast<std::uint32_t>(*octet);
+        begin = dot + 1;
+    }
+
+    return collapsed;
+}
+
+#ifdef IP_FILTER_HAS_SSE41_KERNEL
+
+namespace {
+
+constexpr char kZero = static_cast<char>(0x80); // pshufb: zero the lane
+
+// One shuffle mask per octet-length layout (each octet is 1..3 digits, 3^4
+// layouts). Octet k lands in bytes [4k, 4k + 3] as (hundreds, tens, ones, 0),
+// right-aligned so that a single maddubs with (100, 10, 1, 0) decodes it.
+constexpr auto kLayoutShuffles = [] {
+    std::array<std::array<char, 16>, 81> table{};
+
+    for (int layout = 0; layout < 81; ++layout) {
+        std::array<int, 4> lengths{layout / 27 % 3 + 1, layout / 9 % 3 + 1, layout / 3 % 3 + 1, layout % 3 + 1};
+
+        int start = 0;
+        for (int k = 0; k < 4; ++k) {
+            const int len = lengths[k];
+            auto &mask = table[layout];
+
+            mask[4 * k + 0] = len == 3 ? static_cast<char>(start) : kZero;
+            mask[4 * k + 1] = len >= 2 ? static_cast<char>(start + len - 2) : kZero;
+            mask[4 * k + 2] = static_cast<char>(start + len - 1);
+            mask[4 * k + 3] = kZero;
+
+            start += len + 1;
+        }
+    }
+
+    return table;
+}();
+
+} // namespace
+
+__attribute__((target("sse4.1")))
+std::expected<std::uint32_t, ParseError> decode_ipv4_sse41(std::string_view field) noexcept {
+    const auto n = field.size();
+    if (n < 7 || n > 15) return decode_ipv4_scalar(field);
+
+    // never read past the field, the tail of the register stays zero
+    alignas(16) char buf[16] = {};
+    std::memcpy(buf, field.data(), n);
+
+    const __m128i input = _mm_load_si128(reinterpret_cast<__m128i const *>(buf));
+    const __m128i digits = _mm_sub_epi8(input, _mm_set1_epi8('0'));
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    const __m128i is_dot = _mm_cmpeq_epi8(input, _mm_set1_epi8('.'));
+
+    const auto in_field = static_cast<unsigned>((1u << n) - 1);
+    const auto dots = static_cast<unsigned>(_mm_movemask_epi8(is_dot)) & in_field;
+    const auto known = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(is_digit, is_dot))) & in_field;
+
+    if (known != in_field || std::popcount(dots) != 3) return decode_ipv4_scalar(field);
+
+    const int p0 = std::countr_zero(dots);
+    const int p1 = std::countr_zero(dots & (dots - 1));
+    const int p2 = 31 - std::countl_zero(dots);
+
+    const int l0 = p0;
+    const int l1 = p1 - p0 - 1;
+    const int l2 = p2 - p1 - 1;
+    const int l3 = static_cast<int>(n) - p2 - 1;
+
+    // empty or zero-padded (4+ digit) octets take the exact path
+    if (std::min({l0, l1, l2, l3}) < 1 || std::max({l0, l1, l2, l3}) > 3) return decode_ipv4_scalar(field);
+
+    const auto layout = static_cast<std::size_t>((l0 - 1) * 27 + (l1 - 1) * 9 + (l2 - 1) * 3 + (l3 - 1));
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<__m128i const *>(kLayoutShuffles[layout].data()));
+
+    const __m128i aligned = _mm_shuffle_epi8(digits, shuffle);
+    const __m128i partial = _mm_maddubs_epi16(aligned, _mm_setr_epi8(100, 10, 1, 0, 100, 10, 1, 0,
+                                                                      100, 10, 1, 0, 100, 10, 1, 0));
+    const __m128i octets = _mm_madd_epi16(partial, _mm_set1_epi16(1));
+
+    if (_mm_movemask_epi8(_mm_cmpgt_epi32(octets, _mm_set1_epi32(255))) != 0) {
+        return std::unexpected(ParseError::NotANumber);
+    }
+
+    const __m128i packed = _mm_packus_epi16(_mm_packus_epi32(octets, octets), octets);
+    const auto little = static_cast<std::uint32_t>(_mm_cvtsi128_si32(packed));
+
+    // byte 0 of the register is the first octet, the collapsed form wants it on top
+    return __builtin_bswap32(little);
+}
+
+bool has_sse41_decoder() noexcept {
+    static const bool supported = __builtin_cpu_supports("sse4.1");
+    return supported;
+}
+
+#else
+
+std::expected<std::uint32_t, ParseError> decode_ipv4_sse41(std::string_view field) noexcept {
+    return decode_ipv4_scalar(field);
+}
+
+bool has_sse41_decoder() noexcept {
+    return false;
+}
+
+#endif
+
+std::expected<std::uint32_t, ParseError> decode_ipv4(std::string_view field) noexcept {
+    using Kernel = std::expected<std::uint32_t, ParseError> (*)(std::string_view) noexcept;
+    static const Kernel kernel = has_sse41_decoder() ? &decode_ipv4_sse41 : &decode_ipv4_scalar;
+
+    return kernel(field);
+}
@@ -1,5 +1,8 @@
 #include "include/data_structs.hpp"
+#include "include/ip_decode.hpp"
+#include "include/ip_format.hpp"
 
+#include <concepts>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -46,10 +49,21 @@ IP::IP(std::array<int, 4> ip): split_ip_{ip}, collapsed_ip_(0) {
                 (static_cast<std::uint32_t>(split_ip_[0]) << 24);
 }
 
+IP::IP(std::uint32_t collapsed) noexcept
+    : split_ip_{static_cast<int>(collapsed >> 24),
+                static_cast<int>((collapsed >> 16) & 0xFF),
+                static_cast<int>((collapsed >> 8) & 0xFF),
+                static_cast<int>(collapsed & 0xFF)},
+      collapsed_ip_(collapsed) {
+}
+
 std::string IP::to_string() const {
-    std::ostringstream oss;
-    oss << split_ip_[0] << '.' << split_ip_[1] << '.' << split_ip_[2] << '.' << split_ip_[3];
-    return oss.str();
+    char text[kMaxIPv4TextLength + 1];
+    return {text, format_ipv4(collapsed_ip_, text)};
+}
+
+std::string CompactIP::to_string() const {
+    return IP(collapsed_ip_).to_string();
 }
 
 
@@ -75,3 +89,179 @@ std::vector<IP> parse_ip_from_pipe() {
 
     return ip_pool;
 }
+
+
+// zero-allocation streaming parser
+namespace {
+
+constexpr bool is_stream_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+constexpr bool is_digit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+std::expected<int, ParseError> parse_octet_fast(std::string_view str) noexcept {
+    // Mirrors `std::stringstream >> int` followed by the eof check in parse_int:
+    // leading whitespace and a sign are allowed, trailing garbage is not.
+    std::size_t pos = 0;
+    while (pos < str.size() && is_stream_space(str[pos])) ++pos;
+
+    bool negative = false;
+    if (pos < str.size() && (str[pos] == '+' || str[pos] == '-')) {
+        negative = str[pos] == '-';
+        ++pos;
+    }
+
+    if (pos == str.size()) return std::unexpected(ParseError::NotANumber);
+
+    int value = 0;
+    for (; pos < str.size(); ++pos) {
+        if (!is_digit(str[pos])) return std::unexpected(ParseError::NotANumber);
+        // saturate instead of overflowing, anything above 255 is rejected anyway
+        value = std::min(value * 10 + (str[pos] - '0'), 256);
+    }
+
+    if (value > 255 || (negative && value != 0)) return std::unexpected(ParseError::NotANumber);
+
+    return value;
+}
+
+std::expected<IP, ParseError> parse_ip_line(std::string_view line) noexcept {
+    auto collapsed = decode_ipv4(line.substr(0, line.find('\t')));
+    if (!collapsed) return std::unexpected(collapsed.error());
+
+    return IP(*collapsed);
+}
+
+namespace {
+
+template <typename Sink>
+void consume_ip_line(std::string_view line, Sink &sink) {
+    if (line.empty()) return;
+
+    const auto field = line.substr(0, line.find('\t'));
+    auto collapsed = decode_ipv4(field);
+    if (collapsed) {
+        sink(*collapsed);
+        return;
+    }
+
+    // sinks that take IPv6 get a second chance at lines that are not dotted quads
+    if constexpr (std::invocable<Sink &, IP6>) {
+        if (field.find(':') != std::string_view::npos) {
+            if (auto ip6 = parse_ip6(field)) {
+                sink(*ip6);
+                return;
+            }
+        }
+    }
+
+    spdlog::warn("failed parsing IP: {}", field);
+}
+
+// Consumes every complete line of `block`, returns where the unfinished tail starts.
+template <typename Sink>
+std::size_t scan_ip_block(std::string_view block, Sink &sink) {
+    std::size_t begin = 0;
+    for (auto eol = block.find('\n'); eol != std::string_view::npos; eol = block.find('\n', begin)) {
+        consume_ip_line(block.substr(begin, eol - begin), sink);
+        begin = eol + 1;
+    }
+    return begin;
+}
+
+// Feeds the collapsed address of every parseable line to `sink`.
+template <typename Sink>
+void scan_ip_lines(std::istream &in, std::size_t block_size, Sink sink) {
+    std::vector<char> buffer(std::max<std::size_t>(block_size, 1));
+    std::size_t filled = 0;
+
+    auto *source = in.rdbuf();
+    while (true) {
+        if (filled == buffer.size()) {
+            // a single line does not fit into the block, widen it
+            buffer.resize(buffer.size() * 2);
+        }
+
+        const auto got = source->sgetn(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+        if (got <= 0) break;
+        filled += static_cast<std::size_t>(got);
+
+        const auto begin = scan_ip_block(std::string_view(buffer.data(), filled), sink);
+        std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(begin),
+                  buffer.begin() + static_cast<std::ptrdiff_t>(filled),
+                  buffer.begin());
+        filled -= begin;
+    }
+
+    // last line without a trailing '\n'
+    consume_ip_line(std::string_view(buffer.data(), filled), sink);
+
+    in.setstate(std::ios::eofbit);
+}
+
+} // namespace
+
+std::vector<IP> parse_ip_from_stream(std::istream &in, std::size_t block_size) {
+    std::vector<IP> ip_pool;
+    scan_ip_lines(in, block_size, [&ip_pool](std::uint32_t collapsed) { ip_pool.emplace_back(collapsed); });
+    return ip_pool;
+}
+
+std::vector<CompactIP> parse_compact_ip_from_stream(std::istream &in, std::size_t block_size) {
+    std::vector<CompactIP> ip_pool;
+    scan_ip_lines(in, block_size, [&ip_pool](std::uint32_t collapsed) { ip_pool.emplace_back(collapsed); });
+    return ip_pool;
+}
+
+void parse_ip_batches(std::istream &in, std::function<void(std::span<std::uint32_t const>)> const &sink,
+                      std::size_t block_size) {
+    constexpr std::size_t kBatch = 4096;
+    std::vector<std::uint32_t> batch;
+    batch.reserve(kBatch);
+
+    scan_ip_lines(in, block_size, [&batch, &sink](std::uint32_t collapsed) {
+        batch.push_back(collapsed);
+        if (batch.size() == kBatch) {
+            sink(batch);
+            batch.clear();
+        }
+    });
+
+    if (!batch.empty()) sink(batch);
+}
+
+void parse_compact_ip_block(std::string_view block, std::vector<CompactIP> &ip_pool) {
+    auto sink = [&ip_pool](std::uint32_t collapsed) { ip_pool.emplace_back(collapsed); };
+
+    const auto tail = scan_ip_block(block, sink);
+    consume_ip_line(block.substr(tail), sink);
+}
+
+namespace {
+
+struct PoolsSink {
+    IPPools &pools;
+
+    void operator()(std::uint32_t collapsed) const { pools.ipv4.emplace_back(collapsed); }
+    void operator()(IP6 ip) const { pools.ipv6.push_back(ip); }
+};
+
+} // namespace
+
+IPPools parse_ip_pools_from_stream(std::istream &in, std::size_t block_size) {
+    IPPools pools;
+    scan_ip_lines(in, block_size, PoolsSink{pools});
+    return pools;
+}
+
+void parse_ip_pools_block(std::string_view block, IPPools &pools) {
+    PoolsSink sink{pools};
+
+    const auto tail = scan_ip_block(block, sink);
+    consume_ip_line(block.substr(tail), sink);
+}
@@ -1,42 +1,206 @@
+#include <array>
 #include <cassert>
+#include <charconv>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <vector>
 
 #include "include/data_structs.hpp"
+#include "include/dedup.hpp"
+#include "include/filter_engine.hpp"
+#include "include/ingest.hpp"
+#include "include/prefix_index.hpp"
+#include "include/snapshot.hpp"
 #include "spdlog/spdlog.h"
 
+namespace {
 
-auto main([[maybe_unused]] int argc, [[maybe_unused]] char const *argv[]) -> int {
-    try {
-        std::vector<IP> ip_pool = parse_ip_from_pipe();
+struct Options {
+    unsigned threads = 0;                      // 0: sequential streaming parse of stdin
+    std::optional<std::string> input;          // TSV or snapshot file to mmap instead of stdin
+    std::optional<std::string> save_snapshot;  // write the sorted pool here
+    bool verify = false;                       // checksum every address of an input snapshot
+    bool unique = false;                       // stream out distinct addresses only
+    std::optional<std::size_t> top;            // stream out the K most frequent addresses
+};
+
+constexpr std::size_t kMaxThreads = 1024;
+constexpr std::size_t kMaxTop = std::size_t{1} << 20; // TopKCounter keeps 4 * K counters
 
-        IP::sort_reverse_lex(ip_pool);
+// a decimal number in 1..max and nothing else
+std::optional<std::size_t> parse_count(std::string_view text, std::size_t max) {
+    std::size_t value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size() || value == 0 || value > max) return std::nullopt;
+    return value;
+}
 
-        auto print_all = [&](auto const &ips) {
-            for (auto const &ip: ips) std::cout << ip.to_string() << '\n';
-        };
+std::optional<Options> parse_options(int argc, char const *argv[]) {
+    Options options;
 
-        auto print_filtered = [&](auto const &ips, auto pred) {
-            for (auto const &ip: ips) {
-                if (pred(ip)) std::cout << ip.to_string() << '\n';
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--threads" && i + 1 < argc) {
+            const auto threads = parse_count(argv[++i], kMaxThreads);
+            if (!threads) {
+                spdlog::error("--threads expects a number from 1 to {}, got '{}'", kMaxThreads, argv[i]);
+                return std::nullopt;
+            }
+            options.threads = static_cast<unsigned>(*threads);
+        } else if (arg == "--save-snapshot" && i + 1 < argc) {
+            options.save_snapshot = argv[++i];
+        } else if (arg == "--verify") {
+            options.verify = true;
+        } else if (arg == "--unique") {
+            options.unique = true;
+        } else if (arg == "--top" && i + 1 < argc) {
+            options.top = parse_count(argv[++i], kMaxTop);
+            if (!options.top) {
+                spdlog::error("--top expects a number from 1 to {}, got '{}'", kMaxTop, argv[i]);
+                return std::nullopt;
             }
-        };
+        } else if (!arg.starts_with("--") && !options.input) {
+            options.input = std::string(arg);
+        } else {
+            spdlog::error("Usage: {} [--threads N] [--save-snapshot out.bin] [--verify] [--unique | --top K] "
+                          "[input.tsv | input.bin]", argv[0]);
+            return std::nullopt;
+        }
+    }
 
-        print_all(ip_pool);
+    if (options.unique && options.top) {
+        spdlog::error("--unique and --top are mutually exclusive");
+        return std::nullopt;
+    }
 
-        print_filtered(ip_pool, [](IP const &ip) {
-            return ip.bytes()[0] == 1;
-        });
+    return options;
+}
 
-        print_filtered(ip_pool, [](IP const &ip) {
-            auto b = ip.bytes();
-            return b[0] == 46 && b[1] == 70;
-        });
+// IPv4 and IPv6 lines are separated in the same pass
+IPPools load_sorted_pools(Options const &options) {
+    if (!options.input && options.threads == 0) {
+        auto pools = parse_ip_pools_from_stream(std::cin);
+        CompactIP::sort_reverse_lex(pools.ipv4);
+        IP6::sort_reverse_lex(pools.ipv6);
+        return pools;
+    }
+
+    const unsigned threads = std::max(options.threads, 1u);
+    if (options.input) {
+        MappedFile file(*options.input);
+        return parse_ip_pools_parallel(file.data(), threads);
+    }
+
+    const auto data = read_all(std::cin);
+    return parse_ip_pools_parallel(data, threads);
+}
+
+// everything, then 1.*.*.*, then 46.70.*.*, then any octet == 46
+template <typename Ip>
+void print_filtered(std::span<Ip const> ip_pool) {
+    FilterEngine engine({
+        AddressFilter::all(),
+        AddressFilter::prefix(0x01000000, 8),
+        AddressFilter::prefix(0x2E460000, 16),
+        AddressFilter::any_octet(46),
+    });
+
+    engine.run(ip_pool);
+    engine.write_to(std::cout);
+}
+
+// IPv6 addresses, if any, follow the IPv4 listing
+void print_filtered(std::span<IP6 const> ip_pool) {
+    if (ip_pool.empty()) return;
 
-        print_filtered(ip_pool, [](IP const &ip) {
-            return std::ranges::any_of(ip.bytes(), [](int v) { return v == 46; });
+    FilterEngine6 engine({Address6Filter::all()});
+    engine.run(ip_pool);
+    engine.write_to(std::cout);
+}
+
+// --unique / --top: addresses are counted as they stream by and never stored
+void run_streaming(Options const &options) {
+    std::optional<Snapshot> snapshot;
+    std::ifstream file;
+    if (options.input && is_snapshot_file(*options.input)) {
+        snapshot.emplace(*options.input, options.verify ? Snapshot::Verify::Full : Snapshot::Verify::Layout);
+    } else if (options.input) {
+        file.open(*options.input, std::ios::binary);
+        if (!file) throw std::runtime_error("cannot open " + *options.input);
+    }
+
+    auto for_each_batch = [&](auto const &sink) {
+        if (!snapshot) {
+            parse_ip_batches(options.input ? file : std::cin, sink);
+            return;
+        }
+        std::array<std::uint32_t, 4096> batch{};
+        const auto pool = snapshot->pool();
+        for (std::size_t begin = 0; begin < pool.size(); begin += batch.size()) {
+            const auto n = std::min(batch.size(), pool.size() - begin);
+            for (std::size_t i = 0; i < n; ++i) batch[i] = pool[begin + i].collapsed();
+            sink(std::span<std::uint32_t const>(batch.data(), n));
+        }
+    };
+
+    if (options.top) {
+        TopKCounter counter(std::max(TopKCounter::kDefaultCapacity, 4 * *options.top));
+        for_each_batch([&counter](std::span<std::uint32_t const> batch) {
+            for (auto address : batch) counter.add(address);
         });
+
+        if (!counter.exact()) spdlog::warn("more distinct addresses than counters, counts are upper bounds");
+        write_top(counter.top(*options.top), std::cout);
+        return;
+    }
+
+    UniqueAddressSet unique;
+    for_each_batch([&unique](std::span<std::uint32_t const> batch) {
+        for (auto address : batch) unique.insert(address);
+    });
+    write_unique(unique, std::cout);
+}
+
+} // namespace
+
+
+auto main(int argc, char const *argv[]) -> int {
+    try {
+        std::ios::sync_with_stdio(false);
+
+        const auto options = parse_options(argc, argv);
+        if (!options) return EXIT_FAILURE;
+
+        if (options->unique || options->top) {
+            run_streaming(*options);
+            return EXIT_SUCCESS;
+        }
+
+        if (options->input && is_snapshot_file(*options->input)) {
+            const Snapshot snapshot(*options->input, options->verify ? Snapshot::Verify::Full
+                                                                     : Snapshot::Verify::Layout);
+            print_filtered(snapshot.pool());
+            return EXIT_SUCCESS;
+        }
+
+        const IPPools pools = load_sorted_pools(*options);
+
+        if (options->save_snapshot) {
+            if (!pools.ipv6.empty()) spdlog::warn("snapshots hold IPv4 only, {} IPv6 addresses not saved", pools.ipv6.size());
+            std::ofstream out(*options->save_snapshot, std::ios::binary);
+            const PrefixIndex index(pools.ipv4);
+            write_snapshot(out, pools.ipv4, &index);
+        }
+
+        print_filtered(std::span<CompactIP const>(pools.ipv4));
+        print_filtered(std::span<IP6 const>(pools.ipv6));
     } catch (const std::exception &e) {
         spdlog::error("exception: {}", e.what());
         return EXIT_FAILURE;
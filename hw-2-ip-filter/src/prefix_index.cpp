@@ -0,0 +1,26 @@
+#include "include/prefix_index.hpp"
+
+#include <charconv>
+
+#include "include/ip_decode.hpp"
+
+std::expected<Cidr, ParseError> parse_cidr(std::string_view text) noexcept {
+    const auto slash = text.find('/');
+
+    auto network = decode_ipv4(text.substr(0, slash));
+    if (!network) return std::unexpected(network.error());
+
+    int bits = 32;
+    if (slash != std::string_view::npos) {
+        const auto length = text.substr(slash + 1);
+        auto [end, ec] = std::from_chars(length.data(), length.data() + length.size(), bits);
+        if (ec != std::errc{} || end != length.data() + length.size() || length.empty() || bits < 0 || bits > 32) {
+            return std::unexpected(ParseError::NotANumber);
+        }
+    }
+
+    Cidr cidr{*network, bits};
+    cidr.network &= cidr.mask();
+    return cidr;
+}
+
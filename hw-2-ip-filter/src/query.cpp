@@ -0,0 +1,102 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "include/data_structs.hpp"
+#include "include/ingest.hpp"
+#include "include/ip_format.hpp"
+#include "include/prefix_index.hpp"
+#include "include/snapshot.hpp"
+#include "spdlog/spdlog.h"
+
+// Ad-hoc queries against an index built once over an input file, or loaded
+// from a snapshot written by `ip_filter_cli --save-snapshot`:
+//
+//   ip_filter_query input.tsv 46.70.0.0/16 1.0.0.0/8 any:46
+//   ip_filter_query pool.bin < queries.txt
+//
+// Each query prints its matches, one address per line, in ip_filter order.
+
+namespace {
+
+template <typename Ip>
+void write_run(std::span<Ip const> run, std::string &out) {
+    for (auto const &ip : run) {
+        const auto size = out.size();
+        out.resize(size + kMaxIPv4TextLength + 1);
+        char *end = format_ipv4(ip.collapsed(), out.data() + size);
+        *end++ = '\n';
+        out.resize(static_cast<std::size_t>(end - out.data()));
+    }
+}
+
+template <typename Ip>
+bool run_query(BasicPrefixIndex<Ip> const &index, std::string_view query, std::string &out) {
+    if (query.starts_with("any:")) {
+        auto octet = parse_octet_fast(query.substr(4));
+        if (!octet) return false;
+
+        index.visit_any_octet(static_cast<std::uint8_t>(*octet), [&out](std::span<Ip const> run) {
+            write_run(run, out);
+        });
+        return true;
+    }
+
+    auto cidr = parse_cidr(query);
+    if (!cidr) return false;
+
+    write_run(index.prefix(*cidr), out);
+    return true;
+}
+
+template <typename Ip>
+void answer_queries(BasicPrefixIndex<Ip> const &index, std::vector<std::string> queries) {
+    if (queries.empty()) {
+        for (std::string line; std::getline(std::cin, line);) {
+            if (!line.empty()) queries.push_back(std::move(line));
+        }
+    }
+
+    std::string out;
+    for (auto const &query : queries) {
+        out.clear();
+        if (!run_query(index, query, out)) {
+            spdlog::warn("bad query: {}", query);
+            continue;
+        }
+        std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+    }
+}
+
+} // namespace
+
+
+auto main(int argc, char const *argv[]) -> int {
+    if (argc < 2) {
+        spdlog::error("Usage: {} <input.tsv | pool.bin> [a.b.c.d/len | any:N]...", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::ios::sync_with_stdio(false);
+
+        std::vector<std::string> queries(argv + 2, argv + argc);
+
+        if (is_snapshot_file(argv[1])) {
+            const Snapshot snapshot(argv[1]);
+            answer_queries(snapshot.index(), std::move(queries));
+            return EXIT_SUCCESS;
+        }
+
+        MappedFile file(argv[1]);
+        const auto ip_pool = parse_sorted_parallel(file.data(), 1);
+        answer_queries(PrefixIndex(ip_pool), std::move(queries));
+    } catch (const std::exception &e) {
+        spdlog::error("exception: {}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
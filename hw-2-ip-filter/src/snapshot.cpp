@@ -0,0 +1,158 @@
+#include "include/snapshot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kIndexSectionSize =
+    (PrefixIndex::kBuckets + 1) * sizeof(std::uint64_t) + PrefixIndex::kBuckets * 4 * sizeof(std::uint64_t);
+
+constexpr std::uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+
+std::uint64_t fnv1a(std::string_view bytes, std::uint64_t hash = kFnvOffset) noexcept {
+    for (unsigned char c : bytes) {
+        hash = (hash ^ c) * kFnvPrime;
+    }
+    return hash;
+}
+
+template <typename T>
+void put_be(std::string &out, T value) {
+    for (int shift = 8 * (sizeof(T) - 1); shift >= 0; shift -= 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+template <typename T>
+T get_be(std::string_view in, std::size_t offset) noexcept {
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value = static_cast<T>((value << 8) | static_cast<unsigned char>(in[offset + i]));
+    }
+    return value;
+}
+
+// Calls sink(std::string_view) with the big-endian address section, block by block.
+template <typename Sink>
+void for_each_pool_block(std::span<CompactIP const> sorted_pool, Sink sink) {
+    constexpr std::size_t kBlock = 1 << 16;
+    std::string block;
+    block.reserve(kBlock * 4);
+
+    for (std::size_t begin = 0; begin < sorted_pool.size(); begin += kBlock) {
+        block.clear();
+        for (auto const &ip : sorted_pool.subspan(begin, std::min(kBlock, sorted_pool.size() - begin))) {
+            put_be(block, ip.collapsed());
+        }
+        sink(std::string_view(block));
+    }
+}
+
+std::string encode_index(PrefixIndex const &index) {
+    std::string section;
+    section.reserve(kIndexSectionSize);
+
+    for (auto boundary : index.boundaries()) put_be(section, boundary);
+    for (auto const &octets : index.low_octets()) {
+        for (auto word : octets) put_be(section, word);
+    }
+    return section;
+}
+
+} // namespace
+
+void write_snapshot(std::ostream &out, std::span<CompactIP const> sorted_pool, PrefixIndex const *index) {
+    std::uint64_t pool_checksum = kFnvOffset;
+    for_each_pool_block(sorted_pool, [&pool_checksum](std::string_view block) {
+        pool_checksum = fnv1a(block, pool_checksum);
+    });
+
+    const std::string index_section = index ? encode_index(*index) : std::string();
+
+    std::string header(kSnapshotMagic);
+    put_be(header, kSnapshotVersion);
+    put_be(header, index ? kSnapshotHasIndex : std::uint32_t{0});
+    put_be(header, static_cast<std::uint64_t>(sorted_pool.size()));
+    put_be(header, pool_checksum);
+    put_be(header, index ? fnv1a(index_section) : std::uint64_t{0});
+    header.resize(kSnapshotHeaderSize, '\0');
+
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    for_each_pool_block(sorted_pool, [&out](std::string_view block) {
+        out.write(block.data(), static_cast<std::streamsize>(block.size()));
+    });
+    out.write(index_section.data(), static_cast<std::streamsize>(index_section.size()));
+
+    if (!out) throw std::runtime_error("snapshot: write failed");
+}
+
+bool is_snapshot_file(std::string const &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    std::array<char, kSnapshotMagic.size()> magic{};
+    ifs.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+
+    return ifs && std::string_view(magic.data(), magic.size()) == kSnapshotMagic;
+}
+
+
+// Snapshot implementation
+Snapshot::Snapshot(std::string const &path, Verify verify) : file_(path) {
+    const auto data = file_.data();
+
+    if (data.size() < kSnapshotHeaderSize || !data.starts_with(kSnapshotMagic)) {
+        throw std::runtime_error("snapshot: " + path + " is not an ip_filter snapshot");
+    }
+    if (const auto version = get_be<std::uint32_t>(data, 8); version != kSnapshotVersion) {
+        throw std::runtime_error("snapshot: unsupported version " + std::to_string(version));
+    }
+
+    const auto flags = get_be<std::uint32_t>(data, 12);
+    const auto count = get_be<std::uint64_t>(data, 16);
+    const auto pool_checksum = get_be<std::uint64_t>(data, 24);
+    const auto index_checksum = get_be<std::uint64_t>(data, 32);
+
+    const std::size_t index_size = (flags & kSnapshotHasIndex) ? kIndexSectionSize : 0;
+    if (count > (data.size() - kSnapshotHeaderSize) / 4 ||
+        data.size() != kSnapshotHeaderSize + count * 4 + index_size) {
+        throw std::runtime_error("snapshot: size does not match the header, file truncated?");
+    }
+
+    const auto pool_bytes = data.substr(kSnapshotHeaderSize, count * 4);
+    index_section_ = data.substr(kSnapshotHeaderSize + count * 4, index_size);
+
+    if (has_index() && fnv1a(index_section_) != index_checksum) {
+        throw std::runtime_error("snapshot: index checksum mismatch");
+    }
+    if (verify == Verify::Full && fnv1a(pool_bytes) != pool_checksum) {
+        throw std::runtime_error("snapshot: address checksum mismatch");
+    }
+
+    pool_ = {reinterpret_cast<PackedIP const *>(pool_bytes.data()), count};
+}
+
+BasicPrefixIndex<PackedIP> Snapshot::index() const {
+    if (!has_index()) return BasicPrefixIndex<PackedIP>(pool_);
+
+    BasicPrefixIndex<PackedIP>::Boundaries boundaries(PrefixIndex::kBuckets + 1);
+    BasicPrefixIndex<PackedIP>::OctetSets low_octets(PrefixIndex::kBuckets);
+
+    std::size_t offset = 0;
+    for (auto &boundary : boundaries) {
+        boundary = get_be<std::uint64_t>(index_section_, offset);
+        offset += sizeof(std::uint64_t);
+    }
+    for (auto &octets : low_octets) {
+        for (auto &word : octets) {
+            word = get_be<std::uint64_t>(index_section_, offset);
+            offset += sizeof(std::uint64_t);
+        }
+    }
+
+    return BasicPrefixIndex<PackedIP>(pool_, std::move(boundaries), std::move(low_octets));
+}
@@ -1,11 +1,20 @@
 #include <gtest/gtest.h>
 
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <random>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "../include/data_structs.hpp" // your header
+#include "../include/dedup.hpp"
+#include "../include/filter_engine.hpp"
+#include "../include/ingest.hpp"
+#include "../include/ip_decode.hpp"
+#include "../include/prefix_index.hpp"
+#include "../include/snapshot.hpp"
 
 static std::vector<int> bytes_vec(const IP &ip) {
     auto b = ip.bytes();
@@ -162,3 +171,552 @@ TEST(ParseOctetTests, RvalueInput) {
     ASSERT_TRUE(r.has_value());
     EXPECT_EQ(*r, 10);
 }
+
+TEST(ParseOctetFastTests, MatchesParseOctet) {
+    for (std::string s : {"0", "7", "255", "256", "-1", "-0", "+12", " 3", "3 ", "", "+", "12abc", "007", "99999999999"}) {
+        auto slow = parse_octet(s);
+        auto fast = parse_octet_fast(s);
+        ASSERT_EQ(slow.has_value(), fast.has_value()) << "input: '" << s << "'";
+        if (slow) {
+            EXPECT_EQ(*slow, *fast) << "input: '" << s << "'";
+        }
+    }
+}
+
+TEST(ParseIpLineTests, ValidLine) {
+    auto r = parse_ip_line("192.168.0.1\t5\t6");
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(bytes_vec(*r), std::vector<int>({192,168,0,1}));
+}
+
+TEST(ParseIpLineTests, InvalidLines) {
+    EXPECT_FALSE(parse_ip_line("").has_value());
+    EXPECT_FALSE(parse_ip_line("\t1.2.3.4").has_value());
+    EXPECT_FALSE(parse_ip_line("1.2.3\t1").has_value());
+    EXPECT_FALSE(parse_ip_line("1.2.3.4.5").has_value());
+    EXPECT_FALSE(parse_ip_line("1.2.3.4.").has_value());
+    EXPECT_FALSE(parse_ip_line("1.2.300.4").has_value());
+    EXPECT_FALSE(parse_ip_line("1.2.three.4").has_value());
+}
+
+TEST(ParseStreamTests, SameAsPipeOnFile) {
+    std::ifstream ifs("data/ip.tsv");
+    ASSERT_TRUE(ifs.is_open());
+    auto cin_buf = std::cin.rdbuf();
+    std::cin.rdbuf(ifs.rdbuf());
+    auto expected_ips = parse_ip_from_pipe();
+    std::cin.rdbuf(cin_buf);
+
+    std::ifstream again("data/ip.tsv");
+    // a tiny block forces lines to straddle block boundaries
+    auto ips = parse_ip_from_stream(again, 7);
+
+    EXPECT_EQ(ips, expected_ips);
+}
+
+TEST(ParseStreamTests, SkipsBadLinesAndKeepsLastLine) {
+    std::istringstream iss("1.2.3.4\tx\n\nbad\t1\n5.6.7.8");
+    auto ips = parse_ip_from_stream(iss);
+
+    ASSERT_EQ(ips.size(), 2u);
+    EXPECT_EQ(bytes_vec(ips[0]), std::vector<int>({1,2,3,4}));
+    EXPECT_EQ(bytes_vec(ips[1]), std::vector<int>({5,6,7,8}));
+}
+
+static void expect_same_as_make_ip(const std::string &field) {
+    auto reference = make_ip(split(field, '.'));
+    auto scalar = decode_ipv4_scalar(field);
+    auto vectorized = decode_ipv4_sse41(field);
+
+    ASSERT_EQ(reference.has_value(), scalar.has_value()) << "field: '" << field << "'";
+    ASSERT_EQ(reference.has_value(), vectorized.has_value()) << "field: '" << field << "'";
+
+    if (reference) {
+        EXPECT_EQ(reference->collapsed(), *scalar) << "field: '" << field << "'";
+        EXPECT_EQ(reference->collapsed(), *vectorized) << "field: '" << field << "'";
+    } else {
+        EXPECT_EQ(reference.error(), scalar.error()) << "field: '" << field << "'";
+        EXPECT_EQ(reference.error(), vectorized.error()) << "field: '" << field << "'";
+    }
+}
+
+TEST(DecodeIPv4Tests, KnownFields) {
+    for (std::string s : {"0.0.0.0", "255.255.255.255", "1.22.133.4", "192.168.0.1", "010.0.0.1",
+                          "256.1.1.1", "1.1.1.999", "1.2.3", "1.2.3.4.5", "1..3.4", ".1.2.3",
+                          "+1.2.3.4", "-0.1.2.3", " 1.2.3.4", "1.2.3.4 ", "0001.2.3.4", "1.2.3.a", ""}) {
+        expect_same_as_make_ip(s);
+    }
+}
+
+TEST(DecodeIPv4Tests, DifferentialFuzz) {
+    if (!has_sse41_decoder()) {
+        GTEST_SKIP() << "SSE4.1 kernel not available on this CPU";
+    }
+
+    std::mt19937 rng(20240601);
+    const std::string alphabet = "0123456789........+- x";
+    std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+    std::uniform_int_distribution<int> length(0, 18);
+    std::uniform_int_distribution<int> octet(0, 300);
+
+    for (int i = 0; i < 50000; ++i) {
+        std::string field;
+        if (i % 2 == 0) {
+            // mostly well-formed, sometimes out of range
+            field = std::to_string(octet(rng)) + "." + std::to_string(octet(rng)) + "." +
+                    std::to_string(octet(rng)) + "." + std::to_string(octet(rng));
+            if (i % 10 == 0) field[static_cast<std::size_t>(octet(rng)) % field.size()] = alphabet[pick(rng)];
+        } else {
+            for (int n = length(rng); n > 0; --n) field.push_back(alphabet[pick(rng)]);
+        }
+
+        expect_same_as_make_ip(field);
+        if (HasFatalFailure()) return;
+    }
+}
+
+TEST(CompactIPTests, BytesAndFormat) {
+    CompactIP ip(IP({192,168,0,1}));
+    EXPECT_EQ(ip.bytes(), (std::array<int, 4>{192,168,0,1}));
+    EXPECT_EQ(ip.collapsed(), 0xC0A80001u);
+    EXPECT_EQ(ip.to_string(), "192.168.0.1");
+    EXPECT_EQ(sizeof(CompactIP), 4u);
+}
+
+TEST(CompactIPTests, RadixSortMatchesComparisonSort) {
+    std::mt19937 rng(42);
+    std::vector<IP> ips;
+    std::vector<CompactIP> compact;
+    for (int i = 0; i < 10000; ++i) {
+        // narrow the top bytes so that skipped radix passes are exercised too
+        auto collapsed = static_cast<std::uint32_t>(rng() & 0x0103FFFFu);
+        ips.emplace_back(collapsed);
+        compact.emplace_back(collapsed);
+    }
+
+    IP::sort_reverse_lex(ips);
+    CompactIP::sort_reverse_lex(compact);
+
+    ASSERT_EQ(ips.size(), compact.size());
+    for (std::size_t i = 0; i < ips.size(); ++i) {
+        EXPECT_EQ(ips[i].collapsed(), compact[i].collapsed());
+    }
+}
+
+TEST(CompactIPTests, ParseStreamSameAsFullIP) {
+    std::ifstream full("data/ip.tsv");
+    std::ifstream compact("data/ip.tsv");
+    auto ips = parse_ip_from_stream(full);
+    auto compact_ips = parse_compact_ip_from_stream(compact);
+
+    ASSERT_EQ(ips.size(), compact_ips.size());
+    for (std::size_t i = 0; i < ips.size(); ++i) {
+        EXPECT_EQ(ips[i].collapsed(), compact_ips[i].collapsed());
+    }
+}
+
+TEST(IngestTests, SplitLineAligned) {
+    std::string data = "1.1.1.1\n2.2.2.2\n3.3.3.3\n4.4.4.4";
+    for (std::size_t parts = 1; parts <= 8; ++parts) {
+        auto chunks = split_line_aligned(data, parts);
+        ASSERT_LE(chunks.size(), parts);
+
+        std::string joined;
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            if (i + 1 < chunks.size()) {
+                EXPECT_EQ(chunks[i].back(), '\n');
+            }
+            joined += chunks[i];
+        }
+        EXPECT_EQ(joined, data);
+    }
+}
+
+TEST(IngestTests, ParallelSameAsSequential) {
+    std::ifstream ifs("data/ip.tsv");
+    auto data = read_all(ifs);
+
+    std::vector<CompactIP> expected_pool;
+    parse_compact_ip_block(data, expected_pool);
+    CompactIP::sort_reverse_lex(expected_pool);
+
+    for (unsigned threads : {1u, 2u, 3u, 8u, 32u}) {
+        EXPECT_EQ(parse_sorted_parallel(data, threads), expected_pool) << "threads: " << threads;
+    }
+}
+
+TEST(IngestTests, MappedFileMatchesStream) {
+    MappedFile file("data/ip.tsv");
+    std::ifstream ifs("data/ip.tsv");
+    EXPECT_EQ(file.data(), read_all(ifs));
+}
+
+TEST(AddressFilterTests, Predicates) {
+    const auto a = CompactIP(IP({46,70,1,2})).collapsed();
+    const auto b = CompactIP(IP({1,46,0,0})).collapsed();
+    const auto c = CompactIP(IP({1,2,3,4})).collapsed();
+
+    EXPECT_TRUE(AddressFilter::all()(a));
+    EXPECT_TRUE(AddressFilter::prefix(0x01000000, 8)(b));
+    EXPECT_FALSE(AddressFilter::prefix(0x01000000, 8)(a));
+    EXPECT_TRUE(AddressFilter::prefix(0x2E460000, 16)(a));
+    EXPECT_FALSE(AddressFilter::prefix(0x2E460000, 16)(b));
+    EXPECT_TRUE(AddressFilter::any_octet(46)(a));
+    EXPECT_TRUE(AddressFilter::any_octet(46)(b));
+    EXPECT_FALSE(AddressFilter::any_octet(46)(c));
+    EXPECT_TRUE(AddressFilter::any_octet(0)(b));
+    EXPECT_FALSE(AddressFilter::any_octet(0)(c));
+}
+
+TEST(FilterEngineTests, SameAsPerFilterPrinting) {
+    std::ifstream ifs("data/ip.tsv");
+    auto ip_pool = parse_compact_ip_from_stream(ifs);
+    CompactIP::sort_reverse_lex(ip_pool);
+
+    std::vector<std::function<bool(CompactIP const &)>> preds{
+        [](CompactIP const &) { return true; },
+        [](CompactIP const &ip) { return ip.bytes()[0] == 1; },
+        [](CompactIP const &ip) { return ip.bytes()[0] == 46 && ip.bytes()[1] == 70; },
+        [](CompactIP const &ip) { return std::ranges::any_of(ip.bytes(), [](int v) { return v == 46; }); },
+    };
+
+    FilterEngine engine({AddressFilter::all(), AddressFilter::prefix(0x01000000, 8),
+                         AddressFilter::prefix(0x2E460000, 16), AddressFilter::any_octet(46)});
+    engine.run(ip_pool);
+
+    ASSERT_EQ(engine.size(), preds.size());
+    for (std::size_t i = 0; i < preds.size(); ++i) {
+        std::string expected_text;
+        for (auto const &ip : ip_pool) {
+            if (preds[i](ip)) expected_text += ip.to_string() + '\n';
+        }
+        EXPECT_EQ(engine.output(i), expected_text) << "filter " << i;
+    }
+}
+
+TEST(IPFormatTests, ExtremeValues) {
+    EXPECT_EQ(IP(0u).to_string(), "0.0.0.0");
+    EXPECT_EQ(IP(0xFFFFFFFFu).to_string(), "255.255.255.255");
+    EXPECT_EQ(IP({10,0,100,9}).to_string(), "10.0.100.9");
+}
+
+static std::vector<CompactIP> random_sorted_pool(std::size_t n, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<CompactIP> pool;
+    for (std::size_t i = 0; i < n; ++i) {
+        // few distinct top bytes so that prefixes actually hit something
+        auto address = static_cast<std::uint32_t>(rng());
+        address = (address & 0x00FFFFFFu) | ((address % 3 == 0 ? 46u : address % 3 == 1 ? 1u : 200u) << 24);
+        if (i % 5 == 0) address = (address & 0xFF00FFFFu) | (70u << 16);
+        pool.emplace_back(address);
+    }
+    CompactIP::sort_reverse_lex(pool);
+    return pool;
+}
+
+TEST(PrefixIndexTests, ParseCidr) {
+    auto c = parse_cidr("46.70.12.34/16");
+    ASSERT_TRUE(c.has_value());
+    EXPECT_EQ(c->network, 0x2E460000u);
+    EXPECT_EQ(c->bits, 16);
+
+    c = parse_cidr("1.2.3.4");
+    ASSERT_TRUE(c.has_value());
+    EXPECT_EQ(c->bits, 32);
+
+    EXPECT_FALSE(parse_cidr("1.2.3.4/33").has_value());
+    EXPECT_FALSE(parse_cidr("1.2.3.4/").has_value());
+    EXPECT_FALSE(parse_cidr("1.2.3/8").has_value());
+}
+
+TEST(PrefixIndexTests, PrefixMatchesLinearScan) {
+    const auto pool = random_sorted_pool(20000, 3);
+    const PrefixIndex index(pool);
+
+    for (std::string const &q : std::vector<std::string>{"0.0.0.0/0", "1.0.0.0/8", "46.0.0.0/7", "46.70.0.0/16", "46.70.128.0/17",
+                                                          "200.70.5.0/24", "46.70.0.0/12", "9.9.9.9/32", pool[17].to_string() + "/32"}) {
+        auto cidr = parse_cidr(q);
+        ASSERT_TRUE(cidr.has_value()) << q;
+
+        std::vector<CompactIP> expected_run;
+        for (auto const &ip : pool) {
+            if ((ip.collapsed() & cidr->mask()) == cidr->network) expected_run.push_back(ip);
+        }
+
+        auto run = index.prefix(*cidr);
+        EXPECT_EQ(std::vector<CompactIP>(run.begin(), run.end()), expected_run) << q;
+    }
+}
+
+TEST(PrefixIndexTests, AnyOctetMatchesLinearScan) {
+    const auto pool = random_sorted_pool(20000, 5);
+    const PrefixIndex index(pool);
+
+    for (int octet : {0, 1, 46, 70, 200, 255}) {
+        std::vector<CompactIP> expected_ips;
+        for (auto const &ip : pool) {
+            if (std::ranges::any_of(ip.bytes(), [octet](int v) { return v == octet; })) expected_ips.push_back(ip);
+        }
+
+        std::vector<CompactIP> got;
+        index.visit_any_octet(static_cast<std::uint8_t>(octet), [&got](std::span<CompactIP const> run) {
+            got.insert(got.end(), run.begin(), run.end());
+        });
+        EXPECT_EQ(got, expected_ips) << "octet " << octet;
+    }
+}
+
+// A unique path under the system temp directory, removed on scope exit.
+class TempFile {
+public:
+    explicit TempFile(std::string const &stem)
+        : path_(std::filesystem::temp_directory_path() /
+                (stem + "_" + std::to_string(std::random_device{}()) + ".bin")) {}
+    TempFile(TempFile const &) = delete;
+    TempFile &operator=(TempFile const &) = delete;
+    ~TempFile() {
+        std::error_code ignored;
+        std::filesystem::remove(path_, ignored);
+    }
+
+    [[nodiscard]] std::string string() const { return path_.string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+TEST(SnapshotTests, RoundTripWithIndex) {
+    const auto pool = random_sorted_pool(5000, 9);
+    const PrefixIndex index(pool);
+    const TempFile file("snapshot_test");
+    {
+        std::ofstream out(file.string(), std::ios::binary);
+        write_snapshot(out, pool, &index);
+    }
+
+    ASSERT_TRUE(is_snapshot_file(file.string()));
+    EXPECT_FALSE(is_snapshot_file("data/ip.tsv"));
+
+    const Snapshot snapshot(file.string(), Snapshot::Verify::Full);
+    ASSERT_TRUE(snapshot.has_index());
+    ASSERT_EQ(snapshot.pool().size(), pool.size());
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        EXPECT_EQ(snapshot.pool()[i].collapsed(), pool[i].collapsed());
+    }
+
+    const auto loaded = snapshot.index();
+    EXPECT_EQ(loaded.boundaries(), index.boundaries());
+    EXPECT_EQ(loaded.low_octets(), index.low_octets());
+
+    const auto cidr = *parse_cidr("46.70.0.0/16");
+    EXPECT_EQ(loaded.prefix(cidr).size(), index.prefix(cidr).size());
+}
+
+TEST(SnapshotTests, RejectsCorruption) {
+    const auto pool = random_sorted_pool(100, 10);
+    std::ostringstream oss;
+    write_snapshot(oss, pool);
+    auto bytes = oss.str();
+
+    const TempFile file("snapshot_bad");
+    auto write_file = [&file](std::string const &data) {
+        std::ofstream out(file.string(), std::ios::binary);
+        out << data;
+    };
+
+    // flipped address byte: only the full verification sees it
+    auto flipped = bytes;
+    flipped[kSnapshotHeaderSize + 5] ^= 0x01;
+    write_file(flipped);
+    EXPECT_NO_THROW(Snapshot(file.string(), Snapshot::Verify::Layout));
+    EXPECT_THROW(Snapshot(file.string(), Snapshot::Verify::Full), std::runtime_error);
+
+    write_file(bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW(Snapshot(file.string()), std::runtime_error);
+
+    auto future = bytes;
+    future[11] = 2;
+    write_file(future);
+    EXPECT_THROW(Snapshot(file.string()), std::runtime_error);
+}
+
+TEST(UniqueAddressSetTests, SortedDistinct) {
+    std::mt19937 rng(13);
+    UniqueAddressSet unique;
+    std::vector<std::uint32_t> all;
+    for (int i = 0; i < 50000; ++i) {
+        auto address = static_cast<std::uint32_t>(rng() % 20000) * 7919u;
+        all.push_back(address);
+        unique.insert(address);
+    }
+    unique.insert(0);
+    all.push_back(0);
+
+    std::ranges::sort(all, std::greater<>{});
+    all.erase(std::unique(all.begin(), all.end()), all.end());
+
+    std::vector<std::uint32_t> got;
+    unique.visit_descending([&got](std::uint32_t a) { got.push_back(a); });
+
+    EXPECT_FALSE(unique.uses_bitmap());
+    EXPECT_EQ(unique.size(), all.size());
+    EXPECT_EQ(got, all);
+}
+
+TEST(TopKCounterTests, ExactWithinCapacity) {
+    TopKCounter counter(16);
+    for (std::uint32_t address = 1; address <= 10; ++address) {
+        for (std::uint32_t n = 0; n < address; ++n) counter.add(address);
+    }
+    counter.add(3);
+
+    auto top = counter.top(3);
+    EXPECT_TRUE(counter.exact());
+    ASSERT_EQ(top.size(), 3u);
+    EXPECT_EQ(top[0].address, 10u);
+    EXPECT_EQ(top[0].count, 10u);
+    EXPECT_EQ(top[1].address, 9u);
+    EXPECT_EQ(top[2].address, 8u);
+}
+
+TEST(TopKCounterTests, HeavyHittersSurviveEviction) {
+    std::mt19937 rng(17);
+    TopKCounter counter(64);
+    for (int i = 0; i < 100000; ++i) {
+        // two heavy hitters in a stream of mostly unique noise
+        const auto r = rng();
+        counter.add(i % 10 == 0 ? 0x2E460001u : i % 10 == 1 ? 0x01020304u : static_cast<std::uint32_t>(r));
+    }
+
+    auto top = counter.top(2);
+    EXPECT_FALSE(counter.exact());
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].address, 0x2E460001u);
+    EXPECT_EQ(top[1].address, 0x01020304u);
+    EXPECT_GE(top[0].count, 10000u);
+    EXPECT_LE(top[0].count - top[0].error, 10000u);
+}
+
+TEST(TopKCounterTests, WriteTopFormat) {
+    std::vector<AddressCount> top{{0x01020304u, 7, 0}, {0xFFFFFFFFu, 12345678901ull, 0}};
+    std::ostringstream oss;
+    write_top(top, oss);
+    EXPECT_EQ(oss.str(), "1.2.3.4\t7\n255.255.255.255\t12345678901\n");
+}
+
+TEST(IP6Tests, ParseCompressed) {
+    struct Case {
+        std::string_view text;
+        std::uint64_t high;
+        std::uint64_t low;
+    };
+    const Case cases[] = {
+        {"::", 0, 0},
+        {"::1", 0, 1},
+        {"1::", 0x0001000000000000ull, 0},
+        {"2001:db8::8a2e:370:7334", 0x20010DB800000000ull, 0x00008A2E03707334ull},
+        {"2001:0DB8:0000:0000:0000:0000:0000:0001", 0x20010DB800000000ull, 1},
+        {"fe80::1:2:3:4", 0xFE80000000000000ull, 0x0001000200030004ull},
+        {"1:2:3:4:5:6:7::", 0x0001000200030004ull, 0x0005000600070000ull},
+        {"::ffff:192.168.0.1", 0, 0x0000FFFFC0A80001ull},
+        {"64:ff9b::10.0.0.1", 0x0064FF9B00000000ull, 0x000000000A000001ull},
+    };
+
+    for (auto const &c : cases) {
+        auto ip = parse_ip6(c.text);
+        ASSERT_TRUE(ip.has_value()) << c.text;
+        EXPECT_EQ(ip->high(), c.high) << c.text;
+        EXPECT_EQ(ip->low(), c.low) << c.text;
+    }
+}
+
+TEST(IP6Tests, ParseRejects) {
+    for (std::string_view text : {"", ":", ":::", "1:::2", "1::2::3", ":1::", "1:", "12345::", "g::",
+                                  "1:2:3:4:5:6:7", "1:2:3:4:5:6:7:8:9", "1::2:3:4:5:6:7:8",
+                                  "1:2:3:4:5:6:7:8::", "::1:2:3:4:5:6:7:8",
+                                  "::1.2.3", "::1.2.3.256", "1:2:3:4:5:6:7:1.2.3.4", "fe80::1%eth0",
+                                  "[::1]", "1.2.3.4"}) {
+        EXPECT_FALSE(parse_ip6(text).has_value()) << text;
+    }
+}
+
+TEST(IP6Tests, FormatRfc5952) {
+    for (std::string_view text : {"::", "::1", "1::", "2001:db8::1", "2001:db8:0:1:1:1:1:1", "2001:0:0:1::1",
+                                  "1:0:0:2::", "fe80::1:2:3:4", "::ffff:192.168.0.1",
+                                  "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"}) {
+        auto ip = parse_ip6(text);
+        ASSERT_TRUE(ip.has_value()) << text;
+        EXPECT_EQ(ip->to_string(), text);
+    }
+
+    EXPECT_EQ(parse_ip6("2001:DB8:0000:0:0:0:0:1")->to_string(), "2001:db8::1");
+}
+
+TEST(IP6Tests, RoundTripAndSort) {
+    std::mt19937_64 rng(23);
+    std::vector<IP6> pool;
+    for (int i = 0; i < 20000; ++i) {
+        // sparse hextets so "::" runs show up
+        std::uint64_t halves[2] = {rng(), rng()};
+        for (auto &half : halves) half &= rng() & rng();
+        pool.emplace_back(halves[0], halves[1]);
+
+        auto parsed = parse_ip6(pool.back().to_string());
+        ASSERT_TRUE(parsed.has_value()) << pool.back().to_string();
+        ASSERT_EQ(*parsed, pool.back());
+    }
+
+    auto expected_pool = pool;
+    std::ranges::sort(expected_pool, std::greater<>{});
+    IP6::sort_reverse_lex(pool);
+    EXPECT_EQ(pool, expected_pool);
+}
+
+TEST(IP6Tests, PrefixFilter) {
+    const auto network = *parse_ip6("2001:db8::");
+    const auto doc = Address6Filter::prefix(network, 32);
+    EXPECT_TRUE(doc(*parse_ip6("2001:db8:ffff::1")));
+    EXPECT_FALSE(doc(*parse_ip6("2001:db9::1")));
+
+    const auto deep = Address6Filter::prefix(*parse_ip6("2001:db8::1:0"), 112);
+    EXPECT_TRUE(deep(*parse_ip6("2001:db8::1:abcd")));
+    EXPECT_FALSE(deep(*parse_ip6("2001:db8::2:abcd")));
+
+    EXPECT_TRUE(Address6Filter::prefix(*parse_ip6("::1"), 128)(*parse_ip6("::1")));
+    EXPECT_FALSE(Address6Filter::prefix(*parse_ip6("::1"), 128)(*parse_ip6("::2")));
+    EXPECT_TRUE(Address6Filter::all()(*parse_ip6("ffff::")));
+
+    FilterEngine6 engine({Address6Filter::all(), Address6Filter::prefix(network, 32)});
+    const std::vector<IP6> pool{*parse_ip6("2001:db9::"), *parse_ip6("2001:db8::2"), *parse_ip6("::1")};
+    engine.run(pool);
+    EXPECT_EQ(engine.output(0), "2001:db9::\n2001:db8::2\n::1\n");
+    EXPECT_EQ(engine.output(1), "2001:db8::2\n");
+}
+
+TEST(IP6Tests, MixedInputOnePass) {
+    std::mt19937_64 rng(29);
+    std::string data;
+    IPPools expected_pools;
+    for (int i = 0; i < 30000; ++i) {
+        if (rng() % 2 == 0) {
+            const auto address = static_cast<std::uint32_t>(rng());
+            data += CompactIP(address).to_string() + "\t1\t0\n";
+            expected_pools.ipv4.emplace_back(address);
+        } else {
+            const IP6 ip(rng() & 0xFFFF0000FFFFFFFFull, rng() >> (rng() % 64));
+            data += ip.to_string() + "\t1\t0\n";
+            expected_pools.ipv6.push_back(ip);
+        }
+    }
+    data += "garbage\t1\t0\n";
+
+    std::istringstream in(data);
+    auto streamed = parse_ip_pools_from_stream(in, 4096);
+    EXPECT_EQ(streamed, expected_pools);
+
+    CompactIP::sort_reverse_lex(expected_pools.ipv4);
+    IP6::sort_reverse_lex(expected_pools.ipv6);
+    for (unsigned threads : {1u, 3u, 8u}) {
+        EXPECT_EQ(parse_ip_pools_parallel(data, threads), expected_pools) << "threads: " << threads;
+    }
+}
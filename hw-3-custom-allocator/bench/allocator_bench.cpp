@@ -0,0 +1,272 @@
+// allocator_bench: std::map, std::list, std::unordered_map and MyList with
+// std::allocator and ExpandablePoolAllocator, through insert, erase, churn
+// and lookup patterns on 1K..100M elements.
+//
+// Every case runs in a forked child, so the peak RSS and page faults that
+// wait4() reports for it are its own. Built with ALLOCATOR_BENCH_CHECKS the
+// pool allocator uses PoisonPoolChecks; --inject then shows that a double
+// free or a use after free stops the run.
+//
+// usage: allocator_bench [--min N] [--max N] [--filter TEXT]
+//                        [--inject double-free|use-after-free]
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "include/custom_allocator.hxx"
+#include "include/my_list.hxx"
+
+namespace {
+
+#ifdef ALLOCATOR_BENCH_CHECKS
+using Checks = PoisonPoolChecks;
+#else
+using Checks = NoPoolChecks;
+#endif
+
+template <class T>
+using PoolAllocator = ExpandablePoolAllocator<T, sizeof(T), PoolGrowth<>, NoPoolStats, Checks>;
+
+// keeps lookup results alive without printing them
+volatile long long g_sink = 0;
+
+// distinct keys in scattered order without a key array inflating the RSS
+int key(std::size_t i) {
+    return static_cast<int>(static_cast<std::uint32_t>(i) * 2654435761u);
+}
+
+enum class Pattern { Insert, Erase, Churn, Lookup };
+
+constexpr std::string_view pattern_name(Pattern pattern) {
+    switch (pattern) {
+        case Pattern::Insert: return "insert";
+        case Pattern::Erase: return "erase";
+        case Pattern::Churn: return "churn";
+        case Pattern::Lookup: return "lookup";
+    }
+    return "?";
+}
+
+template <class Alloc>
+using Map = std::map<int, int, std::less<int>, typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<const int, int>>>;
+template <class Alloc>
+using UnorderedMap = std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                                        typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<const int, int>>>;
+template <class Alloc>
+using List = std::list<int, Alloc>;
+template <class Alloc>
+using PlainList = MyList<int, Alloc>;
+
+template <class C>
+constexpr bool kKeyed = requires(C c) { c.find(0); };
+
+template <class C>
+void fill(C &container, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if constexpr (kKeyed<C>) container.emplace(key(i), static_cast<int>(i));
+        else container.push_back(static_cast<int>(i));
+    }
+}
+
+// runs `pattern` on a container of `n` elements, returns the timed operations, 0 if unsupported
+template <class C>
+std::size_t run_pattern(Pattern pattern, std::size_t n, double &seconds) {
+    constexpr bool kErasable = requires(C c) { c.pop_front(); } || kKeyed<C>;
+    if (pattern == Pattern::Churn && !kErasable) return 0;
+
+    C container;
+    if (pattern != Pattern::Insert) fill(container, n);
+
+    long long sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    switch (pattern) {
+        case Pattern::Insert:
+            fill(container, n);
+            break;
+        case Pattern::Erase:
+            if constexpr (kKeyed<C>) {
+                for (std::size_t i = n; i-- > 0;) container.erase(key(i));
+            } else if constexpr (kErasable) {
+                while (!container.empty()) container.pop_front();
+            } else {
+                container.clear();
+            }
+            break;
+        case Pattern::Churn:
+            if constexpr (kKeyed<C>) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    container.erase(key(i));
+                    container.emplace(key(n + i), static_cast<int>(i));
+                }
+            } else if constexpr (kErasable) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    container.pop_front();
+                    container.push_back(static_cast<int>(i));
+                }
+            }
+            break;
+        case Pattern::Lookup:
+            if constexpr (kKeyed<C>) {
+                for (std::size_t i = 0; i < n; ++i) sink += container.find(key((i * 7919) % n))->second;
+            } else {
+                for (int value : container) sink += value;
+            }
+            break;
+    }
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    g_sink = sink;
+    return n;
+}
+
+using Runner = std::size_t (*)(Pattern, std::size_t, double &);
+
+struct Subject {
+    std::string_view container;
+    std::string_view allocator;
+    Runner run;
+};
+
+constexpr Subject kSubjects[] = {
+    {"std::map", "std", run_pattern<Map<std::allocator<int>>>},
+    {"std::map", "pool", run_pattern<Map<PoolAllocator<int>>>},
+    {"std::list", "std", run_pattern<List<std::allocator<int>>>},
+    {"std::list", "pool", run_pattern<List<PoolAllocator<int>>>},
+    {"unordered_map", "std", run_pattern<UnorderedMap<std::allocator<int>>>},
+    {"unordered_map", "pool", run_pattern<UnorderedMap<PoolAllocator<int>>>},
+    {"MyList", "std", run_pattern<PlainList<std::allocator<int>>>},
+    {"MyList", "pool", run_pattern<PlainList<PoolAllocator<int>>>},
+};
+
+struct CaseResult {
+    bool ok = false;
+    bool supported = true;
+    double ns_per_op = 0;
+    long peak_rss_kib = 0;
+    long minor_faults = 0;
+    long major_faults = 0;
+};
+
+// one case in a child process; the child sends back ns/op, wait4 brings its usage
+CaseResult run_isolated(const Subject &subject, Pattern pattern, std::size_t n) {
+    int fds[2];
+    if (::pipe(fds) != 0) return {};
+
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+        ::close(fds[0]);
+        double seconds = 0;
+        const std::size_t ops = subject.run(pattern, n, seconds);
+        const double ns_per_op = ops ? seconds * 1e9 / static_cast<double>(ops) : -1.0;
+        [[maybe_unused]] auto written = ::write(fds[1], &ns_per_op, sizeof(ns_per_op));
+        ::_exit(0);
+    }
+    ::close(fds[1]);
+
+    CaseResult result;
+    double ns_per_op = 0;
+    const bool got = pid > 0 && ::read(fds[0], &ns_per_op, sizeof(ns_per_op)) == sizeof(ns_per_op);
+    ::close(fds[0]);
+
+    int status = 0;
+    rusage usage{};
+    if (pid < 0 || ::wait4(pid, &status, 0, &usage) != pid) return {};
+
+    result.ok = got && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    result.supported = ns_per_op >= 0;
+    result.ns_per_op = ns_per_op;
+    result.peak_rss_kib = usage.ru_maxrss;
+    result.minor_faults = usage.ru_minflt;
+    result.major_faults = usage.ru_majflt;
+    return result;
+}
+
+// a deliberate bug on the pool allocator; with checks on this does not return
+int inject(std::string_view bug) {
+    PoolAllocator<long> alloc;
+    long *p = alloc.allocate(4);
+    p[0] = 1;
+
+    if (bug == "double-free") {
+        alloc.deallocate(p, 4);
+        alloc.deallocate(p, 4);
+    } else if (bug == "use-after-free") {
+        alloc.deallocate(p, 4);
+        p[2] = 42;
+        [[maybe_unused]] long *again = alloc.allocate(4);
+    } else {
+        std::fprintf(stderr, "unknown bug '%.*s'\n", static_cast<int>(bug.size()), bug.data());
+        return 2;
+    }
+
+    std::printf("%.*s went unnoticed (built without ALLOCATOR_BENCH_CHECKS?)\n", static_cast<int>(bug.size()), bug.data());
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::size_t min_elements = 1'000;
+    std::size_t max_elements = 1'000'000;
+    std::string_view filter;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--min" && value) min_elements = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max" && value) max_elements = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--filter" && value) filter = argv[++i];
+        else if (arg == "--inject" && value) return inject(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: %s [--min N] [--max N] [--filter TEXT] [--inject double-free|use-after-free]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("%-14s %-5s %-7s %11s %10s %12s %12s %8s\n",
+                "container", "alloc", "pattern", "elements", "ns/op", "peak_rss_MiB", "minor_faults", "major");
+
+    bool failed = false;
+    for (const auto &subject : kSubjects) {
+        for (Pattern pattern : {Pattern::Insert, Pattern::Erase, Pattern::Churn, Pattern::Lookup}) {
+            for (std::size_t n = min_elements; n <= max_elements; n *= 10) {
+                std::string name = std::string(subject.container) + " " + std::string(subject.allocator) + " " +
+                                   std::string(pattern_name(pattern));
+                if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+
+                const CaseResult result = run_isolated(subject, pattern, n);
+                if (!result.supported) break;
+
+                std::printf("%-14.*s %-5.*s %-7.*s %11zu ",
+                            static_cast<int>(subject.container.size()), subject.container.data(),
+                            static_cast<int>(subject.allocator.size()), subject.allocator.data(),
+                            static_cast<int>(pattern_name(pattern).size()), pattern_name(pattern).data(), n);
+                if (result.ok) {
+                    std::printf("%10.1f %12.1f %12ld %8ld\n", result.ns_per_op, static_cast<double>(result.peak_rss_kib) / 1024,
+                                result.minor_faults, result.major_faults);
+                } else {
+                    std::printf("%10s\n", "FAILED");
+                    failed = true;
+                }
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    return failed ? 1 : 0;
+}
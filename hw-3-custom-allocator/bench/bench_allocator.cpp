@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "include/custom_allocator.hxx"
+
+namespace {
+
+struct Payload {
+    long long value[2];
+};
+
+// containers rebind in noexcept paths, so the converting constructor must not throw
+template <typename Allocator>
+constexpr bool kNothrowRebind =
+        std::is_nothrow_constructible_v<typename std::allocator_traits<Allocator>::template rebind_alloc<Payload>,
+                                        const Allocator &>;
+static_assert(kNothrowRebind<ExpandablePoolAllocator<int>>);
+static_assert(kNothrowRebind<SizeClassPoolAllocator<int>>);
+
+// one allocate + deallocate with `state.range(0)` nodes already on the free list;
+// the time per pair should not depend on the free list length
+void BM_PoolAllocateWithFreeList(benchmark::State &state) {
+    const auto free_nodes = static_cast<std::size_t>(state.range(0));
+    ExpandablePoolAllocator<Payload> pool;
+
+    std::vector<Payload *> nodes(free_nodes);
+    for (auto &node : nodes) node = pool.allocate(1);
+    for (auto *node : nodes) pool.deallocate(node, 1);
+
+    for (auto _ : state) {
+        Payload *p = pool.allocate(1);
+        benchmark::DoNotOptimize(p);
+        pool.deallocate(p, 1);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// fill to `state.range(0)` live nodes, then free them all
+template <typename Allocator>
+void run_fill_drain(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<Payload *> nodes(count);
+    Allocator alloc;
+
+    for (auto _ : state) {
+        for (auto &node : nodes) node = alloc.allocate(1);
+        for (auto *node : nodes) alloc.deallocate(node, 1);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+void BM_PoolFillDrain(benchmark::State &state) {
+    run_fill_drain<ExpandablePoolAllocator<Payload>>(state);
+}
+
+void BM_StdFillDrain(benchmark::State &state) {
+    run_fill_drain<std::allocator<Payload>>(state);
+}
+
+// what PoolStats costs on top of BM_PoolFillDrain
+void BM_PoolFillDrainStats(benchmark::State &state) {
+    run_fill_drain<ExpandablePoolAllocator<Payload, sizeof(Payload), PoolGrowth<>, PoolStats>>(state);
+}
+
+// contiguous runs of `state.range(0)` objects, 1024 live at a time
+template <typename Allocator>
+void run_runs(benchmark::State &state) {
+    const auto length = static_cast<std::size_t>(state.range(0));
+    std::vector<Payload *> runs(1024);
+    Allocator alloc;
+
+    for (auto _ : state) {
+        for (auto &run : runs) run = alloc.allocate(length);
+        for (auto *run : runs) alloc.deallocate(run, length);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(runs.size()) * 2);
+}
+
+void BM_PoolRuns(benchmark::State &state) {
+    run_runs<ExpandablePoolAllocator<Payload>>(state);
+}
+
+void BM_StdRuns(benchmark::State &state) {
+    run_runs<std::allocator<Payload>>(state);
+}
+
+} // namespace
+
+BENCHMARK(BM_PoolAllocateWithFreeList)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_PoolFillDrain)->RangeMultiplier(16)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StdFillDrain)->RangeMultiplier(16)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PoolFillDrainStats)->RangeMultiplier(16)->Range(1 << 10, 1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PoolRuns)->Arg(2)->Arg(8)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StdRuns)->Arg(2)->Arg(8)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,196 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "include/concurrent_pool.hxx"
+
+// Multi-threaded alloc/free of list-node-sized blocks and whole std::map and
+// std::list workloads, ConcurrentPoolAllocator against glibc malloc, on 1..64
+// threads. Run with --benchmark_filter=Concurrent on a machine with enough
+// cores for the upper thread counts to mean anything.
+
+namespace {
+
+struct Node {
+    long long value;
+    Node *next;
+};
+
+// std::map and std::list rebind on every node allocation, which must not throw
+static_assert(std::is_nothrow_constructible_v<ConcurrentPoolAllocator<Node>, const ConcurrentPoolAllocator<int> &>);
+
+constexpr std::size_t kBatch = 256;
+using Batch = std::array<Node *, kBatch>;
+
+// one pool for all threads of a run, like a container shared by a worker pool
+ConcurrentPoolAllocator<Node> &shared_pool() {
+    static ConcurrentPoolAllocator<Node> pool;
+    return pool;
+}
+
+struct PoolAlloc {
+    static Node *allocate() { return shared_pool().allocate(1); }
+    static void deallocate(Node *p) { shared_pool().deallocate(p, 1); }
+};
+
+struct MallocAlloc {
+    static Node *allocate() { return static_cast<Node *>(std::malloc(sizeof(Node))); }
+    static void deallocate(Node *p) { std::free(p); }
+};
+
+// every thread allocates a batch and frees it itself
+template <typename Alloc>
+void run_local(benchmark::State &state) {
+    Batch batch;
+    for (auto _ : state) {
+        for (auto &node : batch) node = Alloc::allocate();
+        benchmark::DoNotOptimize(batch.data());
+        for (auto *node : batch) Alloc::deallocate(node);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kBatch * 2);
+}
+
+// Every thread allocates a batch, posts it and frees a batch some other
+// thread posted, so most frees are remote. The mailbox lock is taken once
+// per batch for both allocators.
+template <typename Alloc>
+void run_remote(benchmark::State &state) {
+    static std::mutex mailbox_mutex;
+    static std::vector<Batch> mailbox;
+
+    Batch batch;
+    Batch received;
+    for (auto _ : state) {
+        for (auto &node : batch) node = Alloc::allocate();
+
+        bool got = false;
+        {
+            std::lock_guard lock(mailbox_mutex);
+            if (!mailbox.empty()) {
+                received = mailbox.back();
+                mailbox.back() = batch;
+                got = true;
+            } else {
+                mailbox.push_back(batch);
+            }
+        }
+
+        if (got) {
+            for (auto *node : received) Alloc::deallocate(node);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * kBatch * 2);
+
+    // the leftovers go back once every thread is done with the mailbox
+    if (state.thread_index() == 0) {
+        std::lock_guard lock(mailbox_mutex);
+        for (auto &left : mailbox) {
+            for (auto *node : left) Alloc::deallocate(node);
+        }
+        mailbox.clear();
+    }
+}
+
+void BM_ConcurrentPoolLocal(benchmark::State &state) {
+    run_local<PoolAlloc>(state);
+}
+
+void BM_ConcurrentMallocLocal(benchmark::State &state) {
+    run_local<MallocAlloc>(state);
+}
+
+void BM_ConcurrentPoolRemote(benchmark::State &state) {
+    run_remote<PoolAlloc>(state);
+}
+
+void BM_ConcurrentMallocRemote(benchmark::State &state) {
+    run_remote<MallocAlloc>(state);
+}
+
+// every thread fills its own container with kBatch elements and empties it,
+// all containers drawing on one resource
+template <typename Container>
+void run_container(benchmark::State &state, const typename Container::allocator_type &alloc) {
+    for (auto _ : state) {
+        Container container(alloc);
+        for (int i = 0; i < static_cast<int>(kBatch); ++i) {
+            if constexpr (requires { container.emplace(i, i); }) container.emplace(i, i);
+            else container.push_back(i);
+        }
+        if (container.size() != kBatch) {
+            state.SkipWithError("container lost elements");
+            break;
+        }
+        benchmark::DoNotOptimize(container);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+template <typename T>
+ConcurrentPoolAllocator<T> shared_container_allocator() {
+    static const auto resource = std::make_shared<ConcurrentPoolResource<>>();
+    return ConcurrentPoolAllocator<T>(resource);
+}
+
+using Entry = std::pair<const int, int>;
+using PoolMap = std::map<int, int, std::less<>, ConcurrentPoolAllocator<Entry>>;
+using PoolList = std::list<int, ConcurrentPoolAllocator<int>>;
+
+void BM_ConcurrentPoolMap(benchmark::State &state) {
+    run_container<PoolMap>(state, shared_container_allocator<Entry>());
+}
+
+void BM_ConcurrentMallocMap(benchmark::State &state) {
+    run_container<std::map<int, int, std::less<>>>(state, {});
+}
+
+void BM_ConcurrentPoolList(benchmark::State &state) {
+    run_container<PoolList>(state, shared_container_allocator<int>());
+}
+
+void BM_ConcurrentMallocList(benchmark::State &state) {
+    run_container<std::list<int>>(state, {});
+}
+
+// One thread creating and destroying short-lived pools: the thread's cache
+// must drop the entries of destroyed pools instead of scanning them forever.
+void BM_ConcurrentPoolChurn(benchmark::State &state) {
+    const std::size_t cached_before = ConcurrentBlockPool<>::thread_cache_count();
+    for (auto _ : state) {
+        ConcurrentPoolAllocator<Node> pool;
+        Node *node = pool.allocate(1);
+        benchmark::DoNotOptimize(node);
+        pool.deallocate(node, 1);
+    }
+
+    // the pool of the last iteration is gone too, but is dropped only on the next miss
+    if (ConcurrentBlockPool<>::thread_cache_count() > cached_before + 1) {
+        state.SkipWithError("thread cache keeps entries of destroyed pools");
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_ConcurrentPoolLocal)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentMallocLocal)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentPoolRemote)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentMallocRemote)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentPoolMap)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentMallocMap)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentPoolList)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentMallocList)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentPoolChurn);
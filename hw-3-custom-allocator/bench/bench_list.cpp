@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "include/custom_allocator.hxx"
+#include "include/my_list.hxx"
+#include "include/pool_stats.hxx"
+
+// push_back and a full traversal over `state.range(0)` ints: std::vector,
+// the classic one-int-per-node MyList, and unrolled MyLists with nodes of a
+// cache line and of a page.
+
+namespace {
+
+using ClassicList = MyList<int>;
+using CacheLineList = UnrolledList<int, kCacheLineBytes>;
+using PageList = UnrolledList<int, kPageBytes>;
+using PoolList = MyList<int, ExpandablePoolAllocator<int>>;
+using StatsPoolList = MyList<int, ExpandablePoolAllocator<int, sizeof(int), PoolGrowth<>, PoolStats>>;
+
+template <typename Container>
+void BM_ListPushBack(benchmark::State &state) {
+    const auto count = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        Container container;
+        for (int i = 0; i < count; ++i) container.push_back(i);
+        benchmark::DoNotOptimize(container.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container>
+void BM_ListIterate(benchmark::State &state) {
+    const auto count = static_cast<int>(state.range(0));
+    Container container;
+    for (int i = 0; i < count; ++i) container.push_back(i);
+
+    for (auto _ : state) {
+        long long sum = 0;
+        for (int value : container) sum += value;
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// push_back one by one against one append_range, which takes a pool
+// allocator's nodes in batches
+template <typename Container>
+void BM_ListAppendRange(benchmark::State &state) {
+    std::vector<int> values(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>(i);
+
+    // a batch is counted as one allocation per node, which clear() frees one by one
+    if constexpr (requires(typename Container::NodeAllocator alloc) { alloc.stats(); }) {
+        Container container;
+        container.append_range(values);
+        const typename Container::NodeAllocator nodes(container.get_allocator());
+        const bool allocated = nodes.stats().allocations() == values.size();
+        container.clear();
+        if (!allocated || nodes.stats().deallocations() != nodes.stats().allocations() || nodes.used_blocks() != 0) {
+            state.SkipWithError("append_range stats do not balance");
+            return;
+        }
+    }
+
+    for (auto _ : state) {
+        Container container;
+        container.append_range(values);
+        benchmark::DoNotOptimize(container.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_ListPushBack<std::vector<int>>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ListPushBack<ClassicList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ListPushBack<CacheLineList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ListPushBack<PageList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ListPushBack<PoolList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ListAppendRange<ClassicList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ListAppendRange<PoolList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ListAppendRange<StatsPoolList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ListIterate<std::vector<int>>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ListIterate<ClassicList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ListIterate<CacheLineList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ListIterate<PageList>)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
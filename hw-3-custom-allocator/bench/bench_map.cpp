@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "include/custom_allocator.hxx"
+
+namespace {
+
+using Value = std::pair<const int, int>;
+
+template <typename Allocator>
+using Map = std::map<int, int, std::less<int>, Allocator>;
+
+std::vector<int> shuffled_keys(std::size_t n) {
+    std::vector<int> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+    return keys;
+}
+
+// building the map, node allocation included
+template <typename Allocator>
+void BM_MapInsert(benchmark::State &state) {
+    const auto keys = shuffled_keys(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        Map<Allocator> map;
+        for (int key : keys) map.emplace(key, key);
+        benchmark::DoNotOptimize(map.size());
+
+        state.PauseTiming();
+        map = {};
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// lookups only; node placement decides how many pages and TLB entries they touch
+template <typename Allocator>
+void BM_MapLookup(benchmark::State &state) {
+    const auto keys = shuffled_keys(static_cast<std::size_t>(state.range(0)));
+    Map<Allocator> map;
+    for (int key : keys) map.emplace(key, key);
+
+    const auto probes = shuffled_keys(keys.size());
+    for (auto _ : state) {
+        long long sum = 0;
+        for (int key : probes) sum += map.find(key)->second;
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// many short-lived maps; sharing one resource keeps its chunks warm across them
+void BM_MapChurnFreshPool(benchmark::State &state) {
+    const auto keys = shuffled_keys(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        Map<ExpandablePoolAllocator<Value>> map;
+        for (int key : keys) map.emplace(key, key);
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_MapChurnSharedPool(benchmark::State &state) {
+    const auto keys = shuffled_keys(static_cast<std::size_t>(state.range(0)));
+    const ExpandablePoolAllocator<Value> shared;
+
+    for (auto _ : state) {
+        Map<ExpandablePoolAllocator<Value>> map(shared);
+        for (int key : keys) map.emplace(key, key);
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using StdAllocator = std::allocator<Value>;
+using FixedPool = ExpandablePoolAllocator<Value, sizeof(Value), FixedPoolGrowth>;
+using GeometricPool = ExpandablePoolAllocator<Value, sizeof(Value), PoolGrowth<64, (std::size_t{32} << 20), false>>;
+using HugePagePool = ExpandablePoolAllocator<Value>;
+
+} // namespace
+
+BENCHMARK(BM_MapInsert<StdAllocator>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapInsert<FixedPool>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapInsert<GeometricPool>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapInsert<HugePagePool>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_MapLookup<StdAllocator>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapLookup<FixedPool>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapLookup<GeometricPool>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapLookup<HugePagePool>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_MapChurnFreshPool)->Arg(1'000)->Arg(100'000);
+BENCHMARK(BM_MapChurnSharedPool)->Arg(1'000)->Arg(100'000);
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <map>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "include/pmr_resource.hxx"
+
+// One "request" builds a pmr::map of pmr::strings and a pmr::vector with
+// `state.range(0)` entries on one memory resource, then gets rid of them.
+// Destroying the containers frees every node on its own; resetting the
+// arena abandons them and drops the memory in one go.
+
+namespace {
+
+struct Request {
+    std::pmr::map<int, std::pmr::string> names;
+    std::pmr::vector<int> ids;
+
+    explicit Request(std::pmr::memory_resource *resource) : names(resource), ids(resource) {}
+
+    void fill(std::size_t entries) {
+        for (std::size_t i = 0; i < entries; ++i) {
+            const int id = static_cast<int>(i * 2654435761u % entries);
+            // long enough to stay out of the small string buffer
+            names.emplace(id, "request-scoped name #" + std::to_string(id));
+            ids.push_back(id);
+        }
+    }
+};
+
+// containers destroyed, every block goes back to the resource
+void run_deallocate(benchmark::State &state, std::pmr::memory_resource *resource) {
+    const auto entries = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        Request request(resource);
+        request.fill(entries);
+        benchmark::DoNotOptimize(request.ids.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// containers abandoned, the resource releases everything at once
+template <typename Resource>
+void run_release(benchmark::State &state) {
+    const auto entries = static_cast<std::size_t>(state.range(0));
+    Resource resource;
+    alignas(Request) std::byte storage[sizeof(Request)];
+
+    for (auto _ : state) {
+        auto *request = ::new (storage) Request(&resource);
+        request->fill(entries);
+        benchmark::DoNotOptimize(request->ids.data());
+        resource.release();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PmrNewDeleteDeallocate(benchmark::State &state) {
+    run_deallocate(state, std::pmr::new_delete_resource());
+}
+
+void BM_PmrStdPoolDeallocate(benchmark::State &state) {
+    std::pmr::unsynchronized_pool_resource resource;
+    run_deallocate(state, &resource);
+}
+
+void BM_PmrPoolDeallocate(benchmark::State &state) {
+    PoolMemoryResource<> resource;
+    run_deallocate(state, &resource);
+}
+
+void BM_PmrMonotonicRelease(benchmark::State &state) {
+    run_release<std::pmr::monotonic_buffer_resource>(state);
+}
+
+void BM_PmrPoolRelease(benchmark::State &state) {
+    run_release<PoolMemoryResource<>>(state);
+}
+
+} // namespace
+
+BENCHMARK(BM_PmrNewDeleteDeallocate)->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PmrStdPoolDeallocate)->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PmrPoolDeallocate)->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PmrMonotonicRelease)->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PmrPoolRelease)->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMicrosecond);
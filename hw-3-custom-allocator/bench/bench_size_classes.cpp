@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+#include "include/custom_allocator.hxx"
+
+// Resident-set growth of a mixed-container workload: a std::map<int, int>,
+// a std::list of 24-byte items and a std::list of 36-character strings,
+// each built with `state.range(0)` elements and dropped before the next one
+// is built, twice over. Map nodes, list items and string buffers all fall in
+// the 48-byte size class. With one pool per block size each of them keeps
+// its own memory; with size classes the next container reuses what the
+// previous one freed.
+
+namespace {
+
+using Item = std::array<int, 6>;
+constexpr char kText[] = "mixed-container workload, 36 chars..";
+
+std::size_t resident_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    std::size_t size = 0;
+    std::size_t resident = 0;
+    statm >> size >> resident;
+    return resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+struct StdMode {
+    template <class T> using Alloc = std::allocator<T>;
+    struct Context {};
+    template <class T> static Alloc<T> make(Context &) { return {}; }
+};
+
+// one resource, pools keyed by each type's BlockSize = sizeof(T)
+struct PerTypeMode {
+    template <class T> using Alloc = ExpandablePoolAllocator<T>;
+    using Context = std::shared_ptr<PoolResource<>>;
+    template <class T> static Alloc<T> make(Context &resource) { return Alloc<T>(resource); }
+};
+
+// one resource, pools keyed by size class
+struct SizeClassMode {
+    template <class T> using Alloc = SizeClassPoolAllocator<T>;
+    using Context = std::shared_ptr<PoolResource<>>;
+    template <class T> static Alloc<T> make(Context &resource) { return Alloc<T>(resource); }
+};
+
+template <class Mode>
+typename Mode::Context make_context() {
+    if constexpr (std::is_same_v<Mode, StdMode>) return {};
+    else return std::make_shared<PoolResource<>>();
+}
+
+template <class Mode>
+void run_phases(typename Mode::Context &context, int n) {
+    using Value = std::pair<const int, int>;
+    using String = std::basic_string<char, std::char_traits<char>, typename Mode::template Alloc<char>>;
+
+    {
+        std::map<int, int, std::less<int>, typename Mode::template Alloc<Value>> map(Mode::template make<Value>(context));
+        for (int i = 0; i < n; ++i) map.emplace(i, i);
+        benchmark::DoNotOptimize(map.size());
+    }
+    {
+        std::list<Item, typename Mode::template Alloc<Item>> items(Mode::template make<Item>(context));
+        for (int i = 0; i < n; ++i) items.push_back({i, i, i, i, i, i});
+        benchmark::DoNotOptimize(items.size());
+    }
+    {
+        const auto chars = Mode::template make<char>(context);
+        std::list<String, typename Mode::template Alloc<String>> strings(Mode::template make<String>(context));
+        for (int i = 0; i < n; ++i) strings.emplace_back(kText, chars);
+        benchmark::DoNotOptimize(strings.size());
+    }
+}
+
+template <class Mode>
+void BM_MixedContainers(benchmark::State &state) {
+    const auto n = static_cast<int>(state.range(0));
+    std::size_t growth = 0;
+
+    for (auto _ : state) {
+        const std::size_t before = resident_bytes();
+        auto context = make_context<Mode>();
+        run_phases<Mode>(context, n);
+        run_phases<Mode>(context, n);
+        const std::size_t after = resident_bytes();
+        growth = after > before ? after - before : 0;
+    }
+
+    state.counters["rss_growth_MiB"] = static_cast<double>(growth) / (1 << 20);
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 6);
+}
+
+} // namespace
+
+BENCHMARK(BM_MixedContainers<PerTypeMode>)->Arg(1'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MixedContainers<SizeClassMode>)->Arg(1'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MixedContainers<StdMode>)->Arg(1'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#if __has_include(<sys/mman.h>)
+#define CUSTOM_ALLOCATOR_HAS_MMAP 1
+#include <sys/mman.h>
+#endif
+
+// Backing memory for allocator chunks.
+//
+// Chunks of kHugePageSize and more are mapped with MAP_HUGETLB when the
+// system has huge pages reserved, otherwise with a plain anonymous mapping
+// marked MADV_HUGEPAGE so that transparent huge pages can back it. Smaller
+// chunks, and every chunk where mmap is unavailable, come from ::operator new.
+namespace chunk_memory {
+
+inline constexpr std::size_t kHugePageSize = std::size_t{2} << 20;
+
+struct Region {
+    void* data;
+    std::size_t bytes;  // usable size, at least what was asked for
+    bool mapped;
+};
+
+[[nodiscard]] inline Region acquire(std::size_t bytes, std::size_t align, bool huge_pages) {
+#ifdef CUSTOM_ALLOCATOR_HAS_MMAP
+    if (huge_pages && bytes >= kHugePageSize) {
+        const std::size_t rounded = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+
+#ifdef MAP_HUGETLB
+        void* mem = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED) return {mem, rounded, true};
+#endif
+
+        void* fallback = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (fallback != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+            ::madvise(fallback, rounded, MADV_HUGEPAGE);
+#endif
+            return {fallback, rounded, true};
+        }
+    }
+#endif
+
+    return {::operator new(bytes, std::align_val_t{align}), bytes, false};
+}
+
+inline void release(Region region, std::size_t align) noexcept {
+#ifdef CUSTOM_ALLOCATOR_HAS_MMAP
+    if (region.mapped) {
+        ::munmap(region.data, region.bytes);
+        return;
+    }
+#endif
+    ::operator delete(region.data, std::align_val_t{align});
+}
+
+} // namespace chunk_memory
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "include/pool_resource.hxx"
+#include "include/size_classes.hxx"
+
+// Thread-safe block pool for node-based containers shared between threads.
+//
+// Single blocks go through per-thread magazines (Bonwick-style): every
+// thread keeps a loaded and a previous magazine of up to kMagazineBlocks
+// blocks and touches shared state only when both are empty or both are full.
+// Full magazines are exchanged through a lock-free Treiber stack whose head
+// carries a 16-bit ABA tag. Fresh blocks, runs of several blocks and the
+// partial magazines of exiting threads go through a BlockPool under a mutex.
+//
+// A block freed by a thread other than the one that allocated it simply
+// lands in the freeing thread's magazine. Blocks are not owned by threads,
+// so a producer/consumer pair keeps circulating full magazines through the
+// stack instead of piling up remote frees.
+template<class Growth = PoolGrowth<>>
+class ConcurrentBlockPool : public std::enable_shared_from_this<ConcurrentBlockPool<Growth>> {
+public:
+    static constexpr std::size_t kMagazineBlocks = 64;
+    static constexpr std::size_t kMinBlockSize = 2 * sizeof(void*);
+
+    ConcurrentBlockPool(std::size_t block_size, std::size_t block_align)
+        : central_(block_size, block_align), id_(next_id_.fetch_add(1, std::memory_order_relaxed)) {
+        assert(block_size >= kMinBlockSize);
+    }
+
+    ConcurrentBlockPool(const ConcurrentBlockPool&) = delete;
+    ConcurrentBlockPool& operator=(const ConcurrentBlockPool&) = delete;
+
+    [[nodiscard]] void* allocate(std::size_t blocks);
+    void deallocate(void* p, std::size_t blocks) noexcept;
+
+    [[nodiscard]] std::size_t block_size() const noexcept { return central_.block_size(); }
+    [[nodiscard]] std::size_t block_align() const noexcept { return central_.block_align(); }
+
+    // blocks taken from the chunks so far, wherever they are now
+    [[nodiscard]] std::size_t total_blocks() const {
+        std::lock_guard lock(mutex_);
+        return central_.total_blocks();
+    }
+
+    // how many pools the calling thread keeps magazines for
+    [[nodiscard]] static std::size_t thread_cache_count() noexcept { return thread_caches().entries.size(); }
+
+private:
+    struct Block {
+        Block* next;           // within a magazine
+        Block* next_magazine;  // within the stack of full magazines
+    };
+
+    struct Magazine {
+        Block* head = nullptr;
+        std::size_t count = 0;
+    };
+
+    // Treiber stack of full magazines; the head packs a 48-bit pointer and a 16-bit tag
+    class MagazineStack {
+    public:
+        void push(Block* magazine) noexcept {
+            std::uint64_t old_head = head_.load(std::memory_order_relaxed);
+            do {
+                std::atomic_ref(magazine->next_magazine).store(pointer_of(old_head), std::memory_order_relaxed);
+            } while (!head_.compare_exchange_weak(old_head, pack(magazine, old_head),
+                                                  std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        Block* pop() noexcept {
+            std::uint64_t old_head = head_.load(std::memory_order_acquire);
+            while (Block* top = pointer_of(old_head)) {
+                // `top` may already be popped and reused by now, but its chunk is
+                // still mapped, and the tag makes the CAS fail if it was.
+                Block* next = std::atomic_ref(top->next_magazine).load(std::memory_order_relaxed);
+                if (head_.compare_exchange_weak(old_head, pack(next, old_head),
+                                                std::memory_order_acquire, std::memory_order_acquire)) {
+                    return top;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        static constexpr std::uint64_t kPointerMask = (std::uint64_t{1} << 48) - 1;
+
+        static Block* pointer_of(std::uint64_t head) noexcept {
+            return reinterpret_cast<Block*>(static_cast<std::uintptr_t>(head & kPointerMask));
+        }
+
+        // new head for `top`, tagged one past the head it replaces
+        static std::uint64_t pack(Block* top, std::uint64_t replaced) noexcept {
+            const auto address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(top));
+            assert((address & ~kPointerMask) == 0 && "user-space addresses are expected to fit 48 bits");
+            return address | ((replaced & ~kPointerMask) + (kPointerMask + 1));
+        }
+
+        std::atomic<std::uint64_t> head_{0};
+    };
+
+    // this thread's magazines for one pool
+    struct ThreadCache {
+        std::uint64_t pool_id;
+        std::weak_ptr<ConcurrentBlockPool> pool;
+        Magazine loaded;
+        Magazine previous;
+    };
+
+    // every live pool this thread has used; partial magazines go back on thread
+    // exit, entries of destroyed pools are dropped on the next cache miss
+    struct ThreadCaches {
+        std::vector<ThreadCache> entries;
+        std::size_t last = 0;
+
+        ~ThreadCaches() {
+            for (auto& entry : entries) {
+                if (auto pool = entry.pool.lock()) pool->return_blocks(entry);
+            }
+        }
+    };
+
+    static ThreadCaches& thread_caches() noexcept {
+        thread_local ThreadCaches caches;
+        return caches;
+    }
+
+    ThreadCache& local_cache();
+    void refill(Magazine& magazine);
+    void return_blocks(ThreadCache& cache) noexcept;
+
+    static inline std::atomic<std::uint64_t> next_id_{1};
+
+    mutable std::mutex mutex_;
+    BlockPool<Growth> central_;
+    MagazineStack full_;
+    const std::uint64_t id_;
+};
+
+// Owner of the concurrent pools a family of allocator handles shares.
+template<class Growth = PoolGrowth<>>
+class ConcurrentPoolResource {
+public:
+    ConcurrentPoolResource() = default;
+
+    ConcurrentPoolResource(const ConcurrentPoolResource&) = delete;
+    ConcurrentPoolResource& operator=(const ConcurrentPoolResource&) = delete;
+
+    [[nodiscard]] ConcurrentBlockPool<Growth>* pool(std::size_t block_size, std::size_t block_align) {
+        std::lock_guard lock(mutex_);
+        for (auto& pool : pools_) {
+            if (pool->block_size() == block_size && pool->block_align() == block_align) return pool.get();
+        }
+        return pools_.emplace_back(std::make_shared<ConcurrentBlockPool<Growth>>(block_size, block_align)).get();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<ConcurrentBlockPool<Growth>>> pools_;
+};
+
+// ExpandablePoolAllocator's counterpart over a ConcurrentPoolResource:
+// the same handle semantics, safe to use from any number of threads.
+//
+// By default (BlockSize = kSizeClassed) the block size is the size class of
+// T, at least kMinBlockSize, so the node type a container rebinds to takes
+// exactly one block and goes through the per-thread magazines. Types too
+// big or too aligned for any class get a block of their own size. An
+// explicit BlockSize is kept through rebind, as in ExpandablePoolAllocator.
+//
+// A rebound copy looks its pool up on first use, so rebinding never locks,
+// never allocates and never throws. The pool pointer is cached atomically,
+// since one handle may be shared by several threads.
+template<class T, std::size_t BlockSize = kSizeClassed, class Growth = PoolGrowth<>>
+class ConcurrentPoolAllocator {
+public:
+    using value_type = T;
+    using size_type  = std::size_t;
+    using pointer    = T*;
+    using resource_type = ConcurrentPoolResource<Growth>;
+
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::false_type;
+
+    template<class U>
+    struct [[maybe_unused]] rebind {
+        using other = ConcurrentPoolAllocator<U, BlockSize, Growth>;
+    };
+
+    ConcurrentPoolAllocator() : ConcurrentPoolAllocator(std::make_shared<resource_type>()) {}
+
+    explicit ConcurrentPoolAllocator(std::shared_ptr<resource_type> resource)
+        : resource_(std::move(resource)), pool_(resource_->pool(kBlockSize, kBlockAlign)) {}
+
+    ConcurrentPoolAllocator(const ConcurrentPoolAllocator& other) noexcept
+        : resource_(other.resource_), pool_(other.pool_.load(std::memory_order_acquire)) {}
+
+    ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator& other) noexcept {
+        resource_ = other.resource_;
+        pool_.store(other.pool_.load(std::memory_order_acquire), std::memory_order_release);
+        return *this;
+    }
+
+    template<class U>
+    [[maybe_unused]] explicit ConcurrentPoolAllocator(const ConcurrentPoolAllocator<U, BlockSize, Growth>& other) noexcept
+        : resource_(other.resource()) {}
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        return static_cast<T*>(own_pool()->allocate(blocks_for(n)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if (!p || n == 0) {
+            return;
+        }
+        // the pool that gave out `p` exists, so looking it up allocates nothing
+        own_pool()->deallocate(p, blocks_for(n));
+    }
+
+    [[nodiscard]] const std::shared_ptr<resource_type>& resource() const noexcept { return resource_; }
+
+private:
+    static constexpr std::size_t kMinBlockSize = ConcurrentBlockPool<Growth>::kMinBlockSize;
+    static constexpr std::size_t kClassIndex =
+            BlockSize == kSizeClassed ? size_classes::index_of(std::max(sizeof(T), kMinBlockSize), alignof(T))
+                                      : size_classes::kCount;
+    static constexpr bool kClassed = kClassIndex < size_classes::kCount;
+
+    static constexpr std::size_t kBlockAlign =
+            kClassed ? size_classes::align_of(size_classes::kSizes[kClassIndex]) : std::max(alignof(T), alignof(void*));
+    static constexpr std::size_t kBlockSize =
+            kClassed ? size_classes::kSizes[kClassIndex]
+                     : (std::max(BlockSize == kSizeClassed ? sizeof(T) : BlockSize, kMinBlockSize) + kBlockAlign - 1)
+                               / kBlockAlign * kBlockAlign;
+
+    static constexpr std::size_t blocks_for(std::size_t n) noexcept {
+        return (n * sizeof(T) + kBlockSize - 1) / kBlockSize;
+    }
+
+    // this allocator's pool, created in the resource on first use; threads
+    // racing here get the same pool from the resource
+    ConcurrentBlockPool<Growth>* own_pool() const {
+        auto* pool = pool_.load(std::memory_order_acquire);
+        if (!pool) {
+            pool = resource_->pool(kBlockSize, kBlockAlign);
+            pool_.store(pool, std::memory_order_release);
+        }
+        return pool;
+    }
+
+    std::shared_ptr<resource_type> resource_;
+    mutable std::atomic<ConcurrentBlockPool<Growth>*> pool_{nullptr};
+};
+
+template <class T, class U, size_t BlockSize, class Growth>
+bool operator==(const ConcurrentPoolAllocator<T, BlockSize, Growth>& a, const ConcurrentPoolAllocator<U, BlockSize, Growth>& b) noexcept {
+    return a.resource() == b.resource();
+}
+
+template <class T, class U, size_t BlockSize, class Growth>
+bool operator!=(const ConcurrentPoolAllocator<T, BlockSize, Growth>& a, const ConcurrentPoolAllocator<U, BlockSize, Growth>& b) noexcept {
+    return !(a == b);
+}
+
+
+template<class Growth>
+auto ConcurrentBlockPool<Growth>::local_cache() -> ThreadCache& {
+    ThreadCaches& caches = thread_caches();
+
+    // pool ids are never reused, so a stale entry of a destroyed pool never matches
+    if (caches.last < caches.entries.size() && caches.entries[caches.last].pool_id == id_) {
+        return caches.entries[caches.last];
+    }
+    for (std::size_t i = 0; i < caches.entries.size();) {
+        auto& entry = caches.entries[i];
+        if (entry.pool_id == id_) {
+            caches.last = i;
+            return entry;
+        }
+
+        // the pool is gone, and with it the blocks in the entry's magazines
+        if (entry.pool.expired()) {
+            entry = std::move(caches.entries.back());
+            caches.entries.pop_back();
+            continue;
+        }
+        ++i;
+    }
+
+    caches.entries.push_back({id_, this->weak_from_this(), {}, {}});
+    caches.last = caches.entries.size() - 1;
+    return caches.entries.back();
+}
+
+// kMagazineBlocks fresh or returned blocks from the central pool
+template<class Growth>
+void ConcurrentBlockPool<Growth>::refill(Magazine& magazine) {
+    std::lock_guard lock(mutex_);
+    for (std::size_t i = 0; i < kMagazineBlocks; ++i) {
+        auto* block = static_cast<Block*>(central_.allocate(1));
+        block->next = magazine.head;
+        magazine.head = block;
+    }
+    magazine.count = kMagazineBlocks;
+}
+
+template<class Growth>
+void ConcurrentBlockPool<Growth>::return_blocks(ThreadCache& cache) noexcept {
+    std::lock_guard lock(mutex_);
+    for (Magazine* magazine : {&cache.loaded, &cache.previous}) {
+        while (Block* block = magazine->head) {
+            magazine->head = block->next;
+            central_.deallocate(block, 1);
+        }
+        magazine->count = 0;
+    }
+}
+
+template<class Growth>
+void* ConcurrentBlockPool<Growth>::allocate(std::size_t blocks) {
+    if (blocks != 1) {
+        std::lock_guard lock(mutex_);
+        return central_.allocate(blocks);
+    }
+
+    ThreadCache& cache = local_cache();
+    if (cache.loaded.count == 0) {
+        if (cache.previous.count != 0) {
+            std::swap(cache.loaded, cache.previous);
+        } else if (Block* magazine = full_.pop()) {
+            cache.loaded = {magazine, kMagazineBlocks};
+        } else {
+            refill(cache.loaded);
+        }
+    }
+
+    Block* block = cache.loaded.head;
+    cache.loaded.head = block->next;
+    --cache.loaded.count;
+    return block;
+}
+
+template<class Growth>
+void ConcurrentBlockPool<Growth>::deallocate(void* p, std::size_t blocks) noexcept {
+    ThreadCache* local = nullptr;
+    if (blocks == 1) {
+        try {
+            local = &local_cache();
+        } catch (...) {
+            // no memory for this thread's cache entry, the block goes to the central pool
+        }
+    }
+    if (!local) {
+        std::lock_guard lock(mutex_);
+        central_.deallocate(p, blocks);
+        return;
+    }
+
+    ThreadCache& cache = *local;
+    if (cache.loaded.count == kMagazineBlocks) {
+        if (cache.previous.count == kMagazineBlocks) {
+            full_.push(cache.previous.head);
+            cache.previous = {};
+        }
+        std::swap(cache.loaded, cache.previous);
+    }
+
+    auto* block = static_cast<Block*>(p);
+    block->next = cache.loaded.head;
+    cache.loaded.head = block;
+    ++cache.loaded.count;
+}
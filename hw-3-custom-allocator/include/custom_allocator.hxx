@@ -5,155 +5,189 @@
 #include <utility>
 #include <algorithm> // Для std::max
 #include <iostream>
-
-template<class T, std::size_t BlockSize = sizeof(T)>
+#include <memory>
+#include <type_traits>
+
+#include "include/pool_resource.hxx"
+#include "include/size_classes.hxx"
+
+// Allocator handle over a reference-counted PoolResource.
+//
+// A default-constructed allocator owns a fresh resource. Copies, rebound
+// copies included, share it, and a rebound copy draws from the resource's
+// pool for its own block size. Several containers can share one warm pool
+// by constructing them from allocators made with the same resource.
+// Allocators compare equal when they share a resource. A rebound copy looks
+// its pool up on first use, so rebinding never allocates and never throws. The allocator
+// propagates on move assignment and swap, so moving a container into one on
+// another pool takes its nodes along and allocates nothing.
+//
+// A request for n objects takes ceil(n * sizeof(T) / BlockSize) contiguous
+// blocks of the pool.
+//
+// With BlockSize = kSizeClassed the block size is the size class of T
+// instead (see size_classes.hxx), picked at compile time, so every rebound
+// type of about the same size allocates from the same pool of the resource.
+// A request for several objects, such as a string buffer, goes to the class
+// of its size in bytes; beyond the largest class it becomes a run of blocks
+// of that class. Types too big or too aligned for any class get a pool of
+// their own, as with BlockSize = sizeof(T).
+//
+// With Stats = PoolStats every pool counts its traffic (see pool_stats.hxx)
+// and resource()->write_stats_json() dumps the counters of all of them.
+// Checks = PoisonPoolChecks turns on double-free and use-after-free
+// detection (see pool_checks.hxx).
+template<class T, std::size_t BlockSize = sizeof(T), class Growth = PoolGrowth<>, class Stats = NoPoolStats,
+         class Checks = NoPoolChecks>
 class ExpandablePoolAllocator {
 public:
     using value_type = T;
     using size_type  = std::size_t;
     using pointer    = T*;
+    using resource_type = PoolResource<Growth, Stats, Checks>;
 
-    template<class U>
-    struct [[maybe_unused]] rebind {
-        using other = ExpandablePoolAllocator<U, BlockSize>;
-    };
-
-    ExpandablePoolAllocator() = default;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::false_type;
 
     template<class U>
-    [[maybe_unused]] constexpr explicit ExpandablePoolAllocator(const ExpandablePoolAllocator<U, BlockSize>&) noexcept {}
-
-    ~ExpandablePoolAllocator() noexcept {
-        release_all();
-    }
-
-    [[nodiscard]] T* allocate(std::size_t n);
-    void deallocate(T* p, std::size_t n) noexcept;
-
-    [[maybe_unused]] [[nodiscard]] std::size_t used_blocks() const noexcept { return used_; }
-    [[maybe_unused]] [[nodiscard]] std::size_t total_blocks() const noexcept { return total_; }
-
-private:
-    struct Node {
-        Node* next;
-    };
-
-    struct Chunk {
-        Chunk* next;
+    struct [[maybe_unused]] rebind {
+        using other = ExpandablePoolAllocator<U, BlockSize, Growth, Stats, Checks>;
     };
 
-    Node* free_list_  = nullptr;
-    Chunk* chunks_     = nullptr;
-    size_t used_       = 0;
-    size_t total_      = 0;
+    ExpandablePoolAllocator() : ExpandablePoolAllocator(std::make_shared<resource_type>()) {}
 
-    void grow(std::size_t additional_blocks);
-    void release_all() noexcept;
-};
+    explicit ExpandablePoolAllocator(std::shared_ptr<resource_type> resource)
+        : resource_(std::move(resource)), pool_(resource_->pool(kBlockSize, kBlockAlign)) {}
 
+    ExpandablePoolAllocator(const ExpandablePoolAllocator&) noexcept = default;
+    ExpandablePoolAllocator& operator=(const ExpandablePoolAllocator&) noexcept = default;
 
-template<class T, std::size_t BlockSize>
-void ExpandablePoolAllocator<T, BlockSize>::grow(std::size_t additional_blocks) {
-    if (additional_blocks == 0) {
-        return;
+    template<class U>
+    [[maybe_unused]] explicit ExpandablePoolAllocator(const ExpandablePoolAllocator<U, BlockSize, Growth, Stats, Checks>& other) noexcept
+        : resource_(other.resource()) {}
+
+    ~ExpandablePoolAllocator() noexcept = default;
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        const auto [pool, blocks] = place(n);
+        if constexpr (Stats::kEnabled) {
+            pool->stats().on_request(n * sizeof(T), blocks * pool->block_size());
+        }
+        return static_cast<T*>(pool->allocate(blocks));
     }
 
-    constexpr size_t ActualBlockSize = std::max(BlockSize, sizeof(Node));
-
-    size_t bytes_to_alloc = sizeof(Chunk) + additional_blocks * ActualBlockSize;
-    void* mem = ::operator new(bytes_to_alloc);
-
-    auto* new_chunk = static_cast<Chunk*>(mem);
-    new_chunk->next = chunks_;
-    chunks_ = new_chunk;
+    void deallocate(T* p, std::size_t n) noexcept {
+        if (!p || n == 0) {
+            return;
+        }
+        // the pool that gave out `p` exists, so looking it up allocates nothing
+        const auto [pool, blocks] = place(n);
+        pool->deallocate(p, blocks);
+    }
 
-    void* blocks_mem = static_cast<void*>(new_chunk + 1);
+    [[nodiscard]] const std::shared_ptr<resource_type>& resource() const noexcept { return resource_; }
 
-    for (std::size_t i = 0; i < additional_blocks; ++i) {
-        auto* node = reinterpret_cast<Node*>(
-                static_cast<std::byte*>(blocks_mem) + i * ActualBlockSize
-        );
-        node->next = free_list_;
-        free_list_ = node;
+    [[maybe_unused]] [[nodiscard]] std::size_t used_blocks() const noexcept {
+        const auto* pool = existing_pool();
+        return pool ? pool->used_blocks() : 0;
     }
-    total_ += additional_blocks;
-}
-
-template<class T, std::size_t BlockSize>
-T* ExpandablePoolAllocator<T, BlockSize>::allocate(std::size_t n) {
-    if (n == 0) {
-        return nullptr;
+    [[maybe_unused]] [[nodiscard]] std::size_t total_blocks() const noexcept {
+        const auto* pool = existing_pool();
+        return pool ? pool->total_blocks() : 0;
     }
 
-    constexpr size_t ActualBlockSize = std::max(BlockSize, sizeof(Node));
-
-    const std::size_t needed_bytes = n * sizeof(T);
-    const std::size_t needed_blocks = (needed_bytes + ActualBlockSize - 1) / ActualBlockSize;
+    // counters of this allocator's pool only
+    [[nodiscard]] const Stats& stats() const requires Stats::kEnabled { return own_pool()->stats(); }
 
-    std::size_t have_blocks = 0;
-    for (Node* cur = free_list_; cur && (have_blocks < needed_blocks); cur = cur->next) {
-        ++have_blocks;
+private:
+    static constexpr std::size_t kClassIndex =
+            BlockSize == kSizeClassed ? size_classes::index_of(sizeof(T), alignof(T)) : size_classes::kCount;
+    static constexpr bool kClassed = kClassIndex < size_classes::kCount;
+
+    static constexpr std::size_t kBlockAlign =
+            kClassed ? size_classes::align_of(size_classes::kSizes[kClassIndex]) : std::max(alignof(T), alignof(void*));
+    static constexpr std::size_t kBlockSize =
+            kClassed ? size_classes::kSizes[kClassIndex]
+                     : (std::max(BlockSize == kSizeClassed ? sizeof(T) : BlockSize, sizeof(void*)) + kBlockAlign - 1)
+                               / kBlockAlign * kBlockAlign;
+
+    static constexpr std::size_t blocks_for(std::size_t n) noexcept {
+        return (n * sizeof(T) + kBlockSize - 1) / kBlockSize;
     }
 
-    if (have_blocks < needed_blocks) {
-        std::size_t grow_by = std::max<std::size_t>(64, needed_blocks - have_blocks);
-        grow(grow_by);
-    }
+    struct Placement {
+        BlockPool<Growth, Stats, Checks>* pool;
+        std::size_t blocks;
+    };
 
-    if (needed_blocks > 1) {
-        return static_cast<T*>(::operator new(needed_bytes));
+    // this allocator's pool, created in the resource on first use
+    BlockPool<Growth, Stats, Checks>* own_pool() const {
+        if (!pool_) pool_ = resource_->pool(kBlockSize, kBlockAlign);
+        return pool_;
     }
 
-    Node* head = free_list_;
-    free_list_ = head->next;
-
-    used_ += needed_blocks;
-    return reinterpret_cast<T*>(head);
-}
-
-
-template<class T, std::size_t BlockSize>
-void ExpandablePoolAllocator<T, BlockSize>::deallocate(T* p, std::size_t n) noexcept {
-    if (!p || n == 0) {
-        return;
+    // this allocator's pool if it exists yet, without creating it
+    BlockPool<Growth, Stats, Checks>* existing_pool() const noexcept {
+        return pool_ ? pool_ : resource_->find_pool(kBlockSize, kBlockAlign);
     }
 
-    constexpr size_t ActualBlockSize = std::max(BlockSize, sizeof(Node));
-
-    const std::size_t needed_bytes = n * sizeof(T);
-    const std::size_t needed_blocks = (needed_bytes + ActualBlockSize - 1) / ActualBlockSize;
-
-    if (needed_blocks > 1) {
-        ::operator delete(p);
-        return;
+    // where a request for n objects goes; only size-classed multi-object requests look at the size
+    Placement place(std::size_t n) const {
+        if constexpr (kClassed) {
+            if (n != 1) {
+                const std::size_t bytes = n * sizeof(T);
+                const std::size_t index = size_classes::index_of(bytes, alignof(T));
+                if (index < size_classes::kCount) return {resource_->class_pool(index), 1};
+                return {resource_->class_pool(size_classes::kCount - 1),
+                        (bytes + size_classes::kMaxSize - 1) / size_classes::kMaxSize};
+            }
+        }
+        return {own_pool(), blocks_for(n)};
     }
 
-    auto* node = reinterpret_cast<Node*>(p);
-    node->next = free_list_;
-    free_list_ = node;
+public:
+    // Up to this many objects taken by one allocate_split() may be given back
+    // one at a time; MyList::append_range uses it to allocate nodes in
+    // batches. It takes objects that fill whole blocks, runs that stay on the
+    // free lists, no size classes, where a run goes to a bigger class, and no
+    // checks, which track whole allocations.
+    static constexpr std::size_t max_split_run =
+            !kClassed && !Checks::kEnabled && sizeof(T) % kBlockSize == 0
+                    ? std::max<std::size_t>(1, BlockPool<Growth, Stats, Checks>::kMaxRunBlocks * kBlockSize / sizeof(T))
+                    : 1;
+
+    // n <= max_split_run contiguous objects, each to be freed with deallocate(p, 1);
+    // the stats count them as n allocations so that they balance the n deallocations
+    [[nodiscard]] T* allocate_split(std::size_t n) requires (max_split_run > 1) {
+        auto* pool = own_pool();
+        if constexpr (Stats::kEnabled) {
+            for (std::size_t i = 0; i < n; ++i) pool->stats().on_request(sizeof(T), sizeof(T));
+        }
+        void* run = pool->allocate(blocks_for(n));
+        pool->stats().on_split(n);
+        return static_cast<T*>(run);
+    }
 
-    used_ -= needed_blocks;
-}
+private:
+    std::shared_ptr<resource_type> resource_;
+    mutable BlockPool<Growth, Stats, Checks>* pool_ = nullptr;
+};
 
-template<class T, std::size_t BlockSize>
-void ExpandablePoolAllocator<T, BlockSize>::release_all() noexcept {
-    Chunk* current = chunks_;
-    while (current) {
-        Chunk* next = current->next;
-        ::operator delete(current);
-        current = next;
-    }
-    chunks_ = nullptr;
-    free_list_ = nullptr;
-    used_ = total_ = 0;
+template <class T, class U, size_t BlockSize, class Growth, class Stats, class Checks>
+bool operator==(const ExpandablePoolAllocator<T, BlockSize, Growth, Stats, Checks>& a, const ExpandablePoolAllocator<U, BlockSize, Growth, Stats, Checks>& b) noexcept {
+    return a.resource() == b.resource();
 }
 
-template <class T, class U, size_t BlockSize>
-constexpr bool operator==(const ExpandablePoolAllocator<T, BlockSize>&, const ExpandablePoolAllocator<U, BlockSize>&) noexcept {
-    return true;
+template <class T, class U, size_t BlockSize, class Growth, class Stats, class Checks>
+bool operator!=(const ExpandablePoolAllocator<T, BlockSize, Growth, Stats, Checks>& a, const ExpandablePoolAllocator<U, BlockSize, Growth, Stats, Checks>& b) noexcept {
+    return !(a == b);
 }
 
-template <class T, class U, size_t BlockSize>
-constexpr bool operator!=(const ExpandablePoolAllocator<T, BlockSize>&, const ExpandablePoolAllocator<U, BlockSize>&) noexcept {
-    return false;
-}
+// ExpandablePoolAllocator in size-classed mode
+template<class T, class Growth = PoolGrowth<>, class Stats = NoPoolStats, class Checks = NoPoolChecks>
+using SizeClassPoolAllocator = ExpandablePoolAllocator<T, kSizeClassed, Growth, Stats, Checks>;
@@ -1,105 +1,328 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
 
-template<typename T, typename Allocator = std::allocator<T>>
+// Element count for an unrolled MyList node of about `node_bytes` bytes,
+// header included; at least two so that the node is actually unrolled.
+template<typename T>
+constexpr std::size_t unrolled_capacity(std::size_t node_bytes) {
+    constexpr std::size_t header = 2 * sizeof(std::size_t);
+    return std::max<std::size_t>(2, (std::max(node_bytes, header) - header) / sizeof(T));
+}
+
+inline constexpr std::size_t kCacheLineBytes = 64;
+inline constexpr std::size_t kPageBytes = 4096;
+
+// Singly linked list with push_back and forward iteration.
+//
+// NodeCapacity = 1 is the classic list, one T per node. A larger capacity
+// makes it an unrolled list: each node holds up to NodeCapacity elements in
+// an inline array and a new node is linked only when the tail one is full,
+// so iterating walks contiguous memory and pays one pointer chase per node.
+//
+// Elements are constructed in place. append_range of a sized range takes
+// the nodes of a classic list in batches when the allocator says a batch
+// can be freed node by node (see ExpandablePoolAllocator::allocate_split).
+// Moving and splicing relink the node chain.
+template<typename T, typename Allocator = std::allocator<T>, std::size_t NodeCapacity = 1>
 class MyList {
-private:
-    struct Node {
+    static_assert(NodeCapacity > 0);
+
+    static constexpr bool kUnrolled = NodeCapacity > 1;
+
+    struct ClassicNode {
         T data;
-        Node* next;
+        ClassicNode* next = nullptr;
+
+        template<typename... Args>
+        explicit ClassicNode(std::in_place_t, Args&&... args) : data(std::forward<Args>(args)...) {}
     };
 
-public:
-    using value_type = T;
-    using allocator_type = Allocator;
-    using size_type = std::size_t;
+    struct UnrolledNode {
+        UnrolledNode* next;
+        std::size_t count;
+        alignas(T) std::byte storage[NodeCapacity * sizeof(T)];
 
-    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+        T* items() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    using Node = std::conditional_t<kUnrolled, UnrolledNode, ClassicNode>;
 
-    class iterator {
+    template<bool Const>
+    class basic_iterator {
     public:
         using iterator_category = std::forward_iterator_tag;
         using value_type = T;
-        using pointer = T*;
-        using reference = T&;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
 
-        explicit iterator(Node* node) : current_(node) {}
+        basic_iterator() = default;
+        explicit basic_iterator(Node* node) : current_(node) {}
 
-        reference operator*() const { return current_->data; }
-        pointer operator->() { return &current_->data; }
+        // iterator -> const_iterator
+        template<bool OtherConst> requires (Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& other) : current_(other.current_), index_(other.index_) {}
+
+        reference operator*() const {
+            if constexpr (kUnrolled) return current_->items()[index_];
+            else return current_->data;
+        }
+        pointer operator->() const { return &**this; }
 
-        iterator& operator++() {
+        basic_iterator& operator++() {
+            if constexpr (kUnrolled) {
+                if (++index_ < current_->count) return *this;
+                index_ = 0;
+            }
             current_ = current_->next;
             return *this;
         }
 
-        iterator operator++(int) {
-            iterator old = *this;
+        basic_iterator operator++(int) {
+            basic_iterator old = *this;
             ++(*this);
             return old;
         }
 
-        friend bool operator==(const iterator& a, const iterator& b) { return a.current_ == b.current_; };
-        friend bool operator!=(const iterator& a, const iterator& b) { return a.current_ != b.current_; };
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) {
+            return a.current_ == b.current_ && a.index_ == b.index_;
+        }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) { return !(a == b); }
 
     private:
-        Node* current_;
+        friend class basic_iterator<!Const>;
+
+        Node* current_ = nullptr;
+        std::size_t index_ = 0;  // within an unrolled node, always 0 in a classic one
     };
 
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    static constexpr size_type node_capacity = NodeCapacity;
+
     MyList() = default;
+    explicit MyList(const Allocator& alloc) : node_alloc_(alloc) {}
+
+    MyList(MyList&& other) noexcept
+        : head_(std::exchange(other.head_, nullptr)),
+          tail_(std::exchange(other.tail_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          node_alloc_(std::move(other.node_alloc_)) {}
+
+    MyList& operator=(MyList&& other) noexcept(
+            std::allocator_traits<NodeAllocator>::propagate_on_container_move_assignment::value ||
+            std::allocator_traits<NodeAllocator>::is_always_equal::value);
 
     ~MyList() {
         clear();
     }
 
-    void push_back(const T& value);
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args);
+
+    template<std::ranges::input_range R>
+    void append_range(R&& range);
+
+    // moves all of `other`'s elements to the end in O(1); allocators must compare equal
+    void splice(MyList& other) noexcept;
+    void splice(MyList&& other) noexcept { splice(other); }
+
     void clear();
 
     [[nodiscard]] size_type size() const { return size_; }
     [[nodiscard]] bool empty() const { return size_ == 0; }
 
+    [[nodiscard]] allocator_type get_allocator() const { return allocator_type(node_alloc_); }
+
     iterator begin() { return iterator(head_); }
     iterator end() { return iterator(nullptr); }
+    const_iterator begin() const { return const_iterator(head_); }
+    const_iterator end() const { return const_iterator(nullptr); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
 
 private:
+    // how many classic nodes append_range takes per allocate_split() call
+    static constexpr size_type kBatchNodes = [] {
+        if constexpr (requires(NodeAllocator& alloc) { alloc.allocate_split(size_type{}); }) return size_type{NodeAllocator::max_split_run};
+        else return size_type{1};
+    }();
+
     Node* head_ = nullptr;
     Node* tail_ = nullptr;
     size_type size_ = 0;
     NodeAllocator node_alloc_{};
+
+    Node* append_node();
+    void link(Node* first, Node* last, size_type count) noexcept;
 };
 
-template<typename T, typename Allocator>
-void MyList<T, Allocator>::push_back(const T& value) {
-    Node* new_node = std::allocator_traits<NodeAllocator>::allocate(node_alloc_, 1);
+// MyList with nodes of about NodeBytes bytes, a cache line by default
+template<typename T, std::size_t NodeBytes = kCacheLineBytes, typename Allocator = std::allocator<T>>
+using UnrolledList = MyList<T, Allocator, unrolled_capacity<T>(NodeBytes)>;
+
+// hangs the chain first..last of `count` elements after the tail
+template<typename T, typename Allocator, std::size_t NodeCapacity>
+void MyList<T, Allocator, NodeCapacity>::link(Node* first, Node* last, size_type count) noexcept {
+    if (tail_) tail_->next = first;
+    else head_ = first;
+    tail_ = last;
+    size_ += count;
+}
+
+// links an empty unrolled node after the tail
+template<typename T, typename Allocator, std::size_t NodeCapacity>
+auto MyList<T, Allocator, NodeCapacity>::append_node() -> Node* {
+    Node* node = std::allocator_traits<NodeAllocator>::allocate(node_alloc_, 1);
+    ::new (static_cast<void*>(node)) Node;
+    node->next = nullptr;
+    node->count = 0;
+
+    link(node, node, 0);
+    return node;
+}
+
+template<typename T, typename Allocator, std::size_t NodeCapacity>
+template<typename... Args>
+auto MyList<T, Allocator, NodeCapacity>::emplace_back(Args&&... args) -> reference {
+    if constexpr (kUnrolled) {
+        Node* previous_tail = tail_;
+        Node* node = (tail_ && tail_->count < NodeCapacity) ? tail_ : append_node();
+        T* slot = node->items() + node->count;
+
+        try {
+            std::allocator_traits<NodeAllocator>::construct(node_alloc_, slot, std::forward<Args>(args)...);
+        } catch (...) {
+            // a node appended for this element must not stay behind empty
+            if (node->count == 0) {
+                tail_ = previous_tail;
+                if (tail_) tail_->next = nullptr;
+                else head_ = nullptr;
+                std::allocator_traits<NodeAllocator>::deallocate(node_alloc_, node, 1);
+            }
+            throw;
+        }
+        ++node->count;
+        ++size_;
+        return *slot;
+    } else {
+        Node* new_node = std::allocator_traits<NodeAllocator>::allocate(node_alloc_, 1);
+
+        try {
+            std::allocator_traits<NodeAllocator>::construct(node_alloc_, new_node, std::in_place, std::forward<Args>(args)...);
+        } catch (...) {
+            std::allocator_traits<NodeAllocator>::deallocate(node_alloc_, new_node, 1);
+            throw;
+        }
 
-    try {
-        std::allocator_traits<NodeAllocator>::construct(node_alloc_, new_node, Node{value, nullptr});
-    } catch (...) {
-        std::allocator_traits<NodeAllocator>::deallocate(node_alloc_, new_node, 1);
-        throw;
+        link(new_node, new_node, 1);
+        return new_node->data;
     }
+}
+
+template<typename T, typename Allocator, std::size_t NodeCapacity>
+template<std::ranges::input_range R>
+void MyList<T, Allocator, NodeCapacity>::append_range(R&& range) {
+    if constexpr (!kUnrolled && kBatchNodes > 1 && std::ranges::sized_range<R>) {
+        auto it = std::ranges::begin(range);
+        for (auto left = static_cast<size_type>(std::ranges::size(range)); left > 0;) {
+            const size_type batch = std::min(left, kBatchNodes);
+            Node* nodes = node_alloc_.allocate_split(batch);
+
+            size_type built = 0;
+            try {
+                for (; built < batch; ++built, ++it) {
+                    std::allocator_traits<NodeAllocator>::construct(node_alloc_, nodes + built, std::in_place, *it);
+                    if (built > 0) nodes[built - 1].next = nodes + built;
+                }
+            } catch (...) {
+                // keep what was built, hand the rest of the batch back
+                for (size_type i = built; i < batch; ++i) {
+                    std::allocator_traits<NodeAllocator>::deallocate(node_alloc_, nodes + i, 1);
+                }
+                if (built > 0) link(nodes, nodes + built - 1, built);
+                throw;
+            }
 
-    if (empty()) {
-        head_ = tail_ = new_node;
+            link(nodes, nodes + batch - 1, batch);
+            left -= batch;
+        }
     } else {
-        tail_->next = new_node;
-        tail_ = new_node;
+        for (auto&& value : range) emplace_back(std::forward<decltype(value)>(value));
     }
-    size_++;
 }
 
-template<typename T, typename Allocator>
-void MyList<T, Allocator>::clear() {
+template<typename T, typename Allocator, std::size_t NodeCapacity>
+auto MyList<T, Allocator, NodeCapacity>::operator=(MyList&& other) noexcept(
+        std::allocator_traits<NodeAllocator>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<NodeAllocator>::is_always_equal::value) -> MyList& {
+    if (this == &other) return *this;
+    clear();
+
+    if constexpr (std::allocator_traits<NodeAllocator>::propagate_on_container_move_assignment::value) {
+        node_alloc_ = std::move(other.node_alloc_);
+    } else if (node_alloc_ != other.node_alloc_) {
+        // the nodes belong to another allocator, only the elements can move
+        for (T& value : other) emplace_back(std::move(value));
+        other.clear();
+        return *this;
+    }
+
+    head_ = std::exchange(other.head_, nullptr);
+    tail_ = std::exchange(other.tail_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+}
+
+template<typename T, typename Allocator, std::size_t NodeCapacity>
+void MyList<T, Allocator, NodeCapacity>::splice(MyList& other) noexcept {
+    assert(node_alloc_ == other.node_alloc_);
+    if (this == &other || other.empty()) return;
+
+    link(other.head_, other.tail_, other.size_);
+    other.head_ = other.tail_ = nullptr;
+    other.size_ = 0;
+}
+
+template<typename T, typename Allocator, std::size_t NodeCapacity>
+void MyList<T, Allocator, NodeCapacity>::clear() {
     Node* current = head_;
     while (current != nullptr) {
         Node* next = current->next;
 
-        std::allocator_traits<NodeAllocator>::destroy(node_alloc_, current);
+        if constexpr (kUnrolled) {
+            for (size_type i = 0; i < current->count; ++i) {
+                std::allocator_traits<NodeAllocator>::destroy(node_alloc_, current->items() + i);
+            }
+        } else {
+            std::allocator_traits<NodeAllocator>::destroy(node_alloc_, current);
+        }
         std::allocator_traits<NodeAllocator>::deallocate(node_alloc_, current, 1);
 
         current = next;
     }
     head_ = tail_ = nullptr;
     size_ = 0;
-}
\ No newline at end of file
+}
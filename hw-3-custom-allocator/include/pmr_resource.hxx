@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+#include "include/pool_resource.hxx"
+
+// std::pmr::memory_resource over one BlockPool per size class, so that
+// pmr::map, pmr::vector and pmr::string can all draw from one arena.
+//
+// Requests of up to kMaxClassBytes go to the smallest power-of-two class
+// that fits both size and alignment, one block each. Requests of up to
+// kMaxRunBytes become runs of blocks in the largest class. Anything bigger
+// or more aligned comes from the upstream resource, with a small header
+// that keeps it on a list of upstream allocations.
+//
+// release() drops every pool's chunks and every upstream allocation at
+// once, which is how a per-request arena is meant to be reset: the
+// containers built on it are abandoned instead of destroyed.
+// Not thread-safe, like std::pmr::unsynchronized_pool_resource.
+template<class Growth = PoolGrowth<>>
+class PoolMemoryResource : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kMinClassBytes = 8;
+    static constexpr std::size_t kMaxClassBytes = 512;
+    static constexpr std::size_t kClassCount = std::countr_zero(kMaxClassBytes / kMinClassBytes) + 1;
+    static constexpr std::size_t kMaxRunBytes = kMaxClassBytes * BlockPool<Growth>::kMaxRunBlocks;
+
+    explicit PoolMemoryResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : upstream_(upstream), pools_(make_pools(std::make_index_sequence<kClassCount>{})) {}
+
+    PoolMemoryResource(const PoolMemoryResource&) = delete;
+    PoolMemoryResource& operator=(const PoolMemoryResource&) = delete;
+
+    ~PoolMemoryResource() override { release(); }
+
+    void release() noexcept {
+        for (auto& pool : pools_) pool.release();
+        while (large_) {
+            Large* next = large_->next;
+            upstream_->deallocate(large_, large_->bytes, large_->alignment);
+            large_ = next;
+        }
+        large_bytes_ = 0;
+    }
+
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+    // bytes in blocks handed out, over all classes, plus upstream allocations
+    [[nodiscard]] std::size_t used_bytes() const noexcept {
+        std::size_t bytes = 0;
+        for (const auto& pool : pools_) bytes += pool.used_blocks() * pool.block_size();
+        return bytes + large_bytes_;
+    }
+
+    // bytes in blocks carved from chunks, over all classes, plus upstream allocations
+    [[nodiscard]] std::size_t total_bytes() const noexcept {
+        std::size_t bytes = 0;
+        for (const auto& pool : pools_) bytes += pool.total_blocks() * pool.block_size();
+        return bytes + large_bytes_;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (alignment > kMaxClassBytes || bytes > kMaxRunBytes) return allocate_large(bytes, alignment);
+
+        if (bytes > kMaxClassBytes) return pools_.back().allocate(run_blocks(bytes));
+        return pools_[class_of(bytes, alignment)].allocate(1);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (alignment > kMaxClassBytes || bytes > kMaxRunBytes) {
+            deallocate_large(p, alignment);
+            return;
+        }
+
+        if (bytes > kMaxClassBytes) {
+            pools_.back().deallocate(p, run_blocks(bytes));
+            return;
+        }
+        pools_[class_of(bytes, alignment)].deallocate(p, 1);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    static constexpr std::size_t class_of(std::size_t bytes, std::size_t alignment) noexcept {
+        const std::size_t fit = std::bit_ceil(std::max({bytes, alignment, kMinClassBytes}));
+        return static_cast<std::size_t>(std::countr_zero(fit / kMinClassBytes));
+    }
+
+    static constexpr std::size_t run_blocks(std::size_t bytes) noexcept {
+        return (bytes + kMaxClassBytes - 1) / kMaxClassBytes;
+    }
+
+    // header in front of an upstream allocation
+    struct Large {
+        Large* prev;
+        Large* next;
+        std::size_t bytes;      // of the whole upstream allocation
+        std::size_t alignment;
+    };
+
+    static constexpr std::size_t large_alignment(std::size_t alignment) noexcept {
+        return std::max(alignment, alignof(Large));
+    }
+
+    static constexpr std::size_t large_offset(std::size_t alignment) noexcept {
+        return (sizeof(Large) + alignment - 1) / alignment * alignment;
+    }
+
+    void* allocate_large(std::size_t bytes, std::size_t alignment) {
+        alignment = large_alignment(alignment);
+        const std::size_t total = large_offset(alignment) + bytes;
+
+        auto* large = static_cast<Large*>(upstream_->allocate(total, alignment));
+        *large = {nullptr, large_, total, alignment};
+        if (large_) large_->prev = large;
+        large_ = large;
+
+        large_bytes_ += total;
+        return reinterpret_cast<std::byte*>(large) + large_offset(alignment);
+    }
+
+    void deallocate_large(void* p, std::size_t alignment) noexcept {
+        alignment = large_alignment(alignment);
+        auto* large = reinterpret_cast<Large*>(static_cast<std::byte*>(p) - large_offset(alignment));
+
+        if (large->prev) large->prev->next = large->next;
+        else large_ = large->next;
+        if (large->next) large->next->prev = large->prev;
+
+        large_bytes_ -= large->bytes;
+        upstream_->deallocate(large, large->bytes, large->alignment);
+    }
+
+    // class i holds blocks of kMinClassBytes << i bytes, aligned to their size
+    template<std::size_t... I>
+    static std::array<BlockPool<Growth>, kClassCount> make_pools(std::index_sequence<I...>) noexcept {
+        return {BlockPool<Growth>(kMinClassBytes << I, kMinClassBytes << I)...};
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::array<BlockPool<Growth>, kClassCount> pools_;
+    Large* large_ = nullptr;
+    std::size_t large_bytes_ = 0;
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unordered_map>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define CUSTOM_ALLOCATOR_HAS_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define CUSTOM_ALLOCATOR_HAS_ASAN 1
+#endif
+#endif
+
+#ifdef CUSTOM_ALLOCATOR_HAS_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+#if __has_include(<valgrind/memcheck.h>)
+#define CUSTOM_ALLOCATOR_HAS_VALGRIND 1
+#include <valgrind/memcheck.h>
+#endif
+
+// Debug policies for BlockPool.
+//
+// NoPoolChecks does nothing. PoisonPoolChecks keeps every block the pool
+// can hand out filled with kFreedByte and, under AddressSanitizer or
+// Valgrind, marked inaccessible, except for the first word of a free run
+// where the pool keeps its free-list link. It aborts with a message on:
+// - a double free, or a free of a pointer the pool never handed out;
+// - a free with a different size than the allocation;
+// - an allocation of a run whose freed bytes were written to after the
+//   free, i.e. a use after free that the sanitizers did not see first;
+// - running out of memory for its own bookkeeping of live allocations.
+// Fresh allocations are filled with kAllocatedByte to make reads of
+// uninitialized memory stand out.
+struct NoPoolChecks {
+    static constexpr bool kEnabled = false;
+
+    void on_chunk(void*, std::size_t) noexcept {}
+    void on_chunk_release(void*, std::size_t) noexcept {}
+    void on_link(void*) noexcept {}
+    void on_allocate(void*, std::size_t) noexcept {}
+    void on_deallocate(void*, std::size_t) noexcept {}
+    void on_release() noexcept {}
+};
+
+class PoisonPoolChecks {
+public:
+    static constexpr bool kEnabled = true;
+    static constexpr unsigned char kFreedByte = 0xDD;
+    static constexpr unsigned char kAllocatedByte = 0xCD;
+
+    // `bytes` of fresh usable memory, none of it handed out yet
+    void on_chunk(void* data, std::size_t bytes) noexcept {
+        std::memset(data, kFreedByte, bytes);
+        poison(data, bytes);
+    }
+
+    void on_chunk_release(void* data, std::size_t bytes) noexcept { unpoison(data, bytes); }
+
+    // the pool is about to write a free-list link at `node`
+    void on_link(void* node) noexcept { unpoison(node, kLinkBytes); }
+
+    void on_allocate(void* p, std::size_t bytes) noexcept {
+        unpoison(p, bytes);
+
+        const auto* bytes_ptr = static_cast<const unsigned char*>(p);
+        for (std::size_t i = kLinkBytes; i < bytes; ++i) {
+            if (bytes_ptr[i] != kFreedByte) {
+                fail("use after free: a freed block was written to", p, i);
+            }
+        }
+
+        try {
+            live_.emplace(p, bytes);
+        } catch (const std::bad_alloc&) {
+            fail("out of memory for the list of live allocations", p, bytes);
+        }
+        std::memset(p, kAllocatedByte, bytes);
+    }
+
+    void on_deallocate(void* p, std::size_t bytes) noexcept {
+        const auto it = live_.find(p);
+        if (it == live_.end()) fail("double free or free of a pointer the pool did not allocate", p, 0);
+        if (it->second != bytes) fail("free with a different size than the allocation", p, bytes);
+        live_.erase(it);
+
+        // the link word stays accessible, the pool writes it right after
+        if (bytes > kLinkBytes) {
+            auto* rest = static_cast<unsigned char*>(p) + kLinkBytes;
+            std::memset(rest, kFreedByte, bytes - kLinkBytes);
+            poison(rest, bytes - kLinkBytes);
+        }
+    }
+
+    // the pool dropped all its chunks, allocations included
+    void on_release() noexcept { live_.clear(); }
+
+    [[nodiscard]] std::size_t live_allocations() const noexcept { return live_.size(); }
+
+private:
+    static constexpr std::size_t kLinkBytes = sizeof(void*);
+
+    [[noreturn]] static void fail(const char* what, const void* p, std::size_t detail) noexcept {
+        std::fprintf(stderr, "pool checks: %s (block %p, %zu)\n", what, p, detail);
+        std::abort();
+    }
+
+    static void poison([[maybe_unused]] void* p, [[maybe_unused]] std::size_t bytes) noexcept {
+#ifdef CUSTOM_ALLOCATOR_HAS_ASAN
+        ASAN_POISON_MEMORY_REGION(p, bytes);
+#endif
+#ifdef CUSTOM_ALLOCATOR_HAS_VALGRIND
+        VALGRIND_MAKE_MEM_NOACCESS(p, bytes);
+#endif
+    }
+
+    static void unpoison([[maybe_unused]] void* p, [[maybe_unused]] std::size_t bytes) noexcept {
+#ifdef CUSTOM_ALLOCATOR_HAS_ASAN
+        ASAN_UNPOISON_MEMORY_REGION(p, bytes);
+#endif
+#ifdef CUSTOM_ALLOCATOR_HAS_VALGRIND
+        VALGRIND_MAKE_MEM_DEFINED(p, bytes);
+#endif
+    }
+
+    std::unordered_map<const void*, std::size_t> live_;
+};
@@ -0,0 +1,336 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <vector>
+
+#include "include/chunk_memory.hxx"
+#include "include/pool_checks.hxx"
+#include "include/pool_stats.hxx"
+#include "include/size_classes.hxx"
+
+// Chunk sizing for the block pools. The first chunk holds FirstChunkBlocks
+// blocks and every next one twice as many, until a chunk would exceed
+// MaxChunkBytes. Chunks of 2 MiB and more are mapped with huge pages when
+// HugePages is set (see chunk_memory.hxx).
+template<std::size_t FirstChunkBlocks = 64, std::size_t MaxChunkBytes = (std::size_t{32} << 20), bool HugePages = true>
+struct PoolGrowth {
+    static constexpr std::size_t kFirstChunkBlocks = FirstChunkBlocks;
+    static constexpr std::size_t kMaxChunkBytes = MaxChunkBytes;
+    static constexpr bool kHugePages = HugePages;
+};
+
+// every chunk the same size, plain ::operator new
+using FixedPoolGrowth = PoolGrowth<64, 0, false>;
+
+// Pool of fixed-size blocks carved out of chunks that grow geometrically.
+//
+// A request takes a number of contiguous blocks. Freed runs of k blocks go to
+// free_lists_[k] (k = 1 is the classic free list), fresh blocks come from a
+// bump pointer in the newest chunk, so allocate and deallocate are O(1) for
+// runs of up to kMaxRunBlocks blocks. Longer runs get a chunk of their own
+// which is released on deallocate. Stats is NoPoolStats or PoolStats (see
+// pool_stats.hxx), Checks NoPoolChecks or PoisonPoolChecks (see
+// pool_checks.hxx). Not thread-safe.
+template<class Growth = PoolGrowth<>, class Stats = NoPoolStats, class Checks = NoPoolChecks>
+class BlockPool {
+public:
+    static constexpr std::size_t kMaxRunBlocks = 64;
+
+    // `block_size` must be a multiple of `block_align`, which must be a power of two
+    BlockPool(std::size_t block_size, std::size_t block_align) noexcept;
+    ~BlockPool() noexcept { release_all(); }
+
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    [[nodiscard]] void* allocate(std::size_t blocks);
+    void deallocate(void* p, std::size_t blocks) noexcept;
+
+    // frees every chunk at once; whatever was allocated from the pool is gone
+    void release() noexcept { release_all(); }
+
+    [[nodiscard]] std::size_t block_size() const noexcept { return block_size_; }
+    [[nodiscard]] std::size_t block_align() const noexcept { return block_align_; }
+    [[nodiscard]] std::size_t used_blocks() const noexcept { return used_; }
+    [[nodiscard]] std::size_t total_blocks() const noexcept { return total_; }
+
+    [[nodiscard]] Stats& stats() noexcept { return stats_; }
+    [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+    [[nodiscard]] const Checks& checks() const noexcept { return checks_; }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    struct Chunk {
+        Chunk* next;
+        Chunk* prev; // only kept up to date in the list of dedicated chunks
+        chunk_memory::Region region;
+    };
+
+    std::size_t block_size_;
+    std::size_t block_align_;
+    std::size_t header_size_;
+    std::size_t max_chunk_blocks_;
+
+    std::array<Node*, kMaxRunBlocks + 1> free_lists_{};
+    std::byte* bump_     = nullptr; // untouched tail of the newest chunk
+    std::byte* bump_end_ = nullptr;
+    Chunk* chunks_     = nullptr;
+    Chunk* dedicated_  = nullptr;   // one chunk per run longer than kMaxRunBlocks
+    size_t next_chunk_blocks_ = Growth::kFirstChunkBlocks;
+    size_t used_       = 0;
+    size_t total_      = 0;
+    [[no_unique_address]] Stats stats_;
+    [[no_unique_address]] Checks checks_;
+
+    Chunk* new_chunk(std::size_t blocks);
+    void delete_chunk(Chunk* chunk) noexcept;
+    void grow(std::size_t min_blocks);
+    std::byte* take_run(std::size_t blocks);
+    void give_back(std::byte* run, std::size_t blocks) noexcept;
+    void* allocate_dedicated(std::size_t blocks);
+    void deallocate_dedicated(void* p, std::size_t blocks) noexcept;
+    void release_all() noexcept;
+};
+
+// Owner of the block pools that a family of allocator handles shares, one
+// pool per (block size, alignment). Pools live as long as the resource.
+template<class Growth = PoolGrowth<>, class Stats = NoPoolStats, class Checks = NoPoolChecks>
+class PoolResource {
+public:
+    PoolResource() = default;
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    // creates the pool on first use; the pointer stays valid for the resource's lifetime
+    [[nodiscard]] BlockPool<Growth, Stats, Checks>* pool(std::size_t block_size, std::size_t block_align) {
+        if (auto* pool = find_pool(block_size, block_align)) return pool;
+        return pools_.emplace_back(std::make_unique<BlockPool<Growth, Stats, Checks>>(block_size, block_align)).get();
+    }
+
+    // the pool if it exists, nullptr otherwise
+    [[nodiscard]] BlockPool<Growth, Stats, Checks>* find_pool(std::size_t block_size, std::size_t block_align) const noexcept {
+        for (auto& pool : pools_) {
+            if (pool->block_size() == block_size && pool->block_align() == block_align) return pool.get();
+        }
+        return nullptr;
+    }
+
+    // the pool of size class `index`, found without a search
+    [[nodiscard]] BlockPool<Growth, Stats, Checks>* class_pool(std::size_t index) {
+        auto*& pool = class_pools_[index];
+        if (!pool) {
+            const std::size_t size = size_classes::kSizes[index];
+            pool = this->pool(size, size_classes::align_of(size));
+        }
+        return pool;
+    }
+
+    [[nodiscard]] std::size_t pool_count() const noexcept { return pools_.size(); }
+
+    // a JSON array with one object per pool
+    void write_stats_json(std::ostream& os) const requires Stats::kEnabled {
+        os << '[';
+        for (std::size_t i = 0; i < pools_.size(); ++i) {
+            const auto& pool = *pools_[i];
+            os << (i ? "," : "")
+               << "{\"block_size\":" << pool.block_size()
+               << ",\"block_align\":" << pool.block_align()
+               << ",\"used_blocks\":" << pool.used_blocks()
+               << ",\"total_blocks\":" << pool.total_blocks()
+               << ",\"stats\":";
+            pool.stats().write_json(os);
+            os << '}';
+        }
+        os << ']';
+    }
+
+private:
+    std::vector<std::unique_ptr<BlockPool<Growth, Stats, Checks>>> pools_;
+    std::array<BlockPool<Growth, Stats, Checks>*, size_classes::kCount> class_pools_{};
+};
+
+
+template<class Growth, class Stats, class Checks>
+BlockPool<Growth, Stats, Checks>::BlockPool(std::size_t block_size, std::size_t block_align) noexcept
+    : block_size_(block_size),
+      block_align_(block_align),
+      header_size_((sizeof(Chunk) + block_align - 1) / block_align * block_align),
+      max_chunk_blocks_(std::max(Growth::kFirstChunkBlocks,
+                                 (std::max(Growth::kMaxChunkBytes, header_size_) - header_size_) / block_size)) {
+}
+
+// The chunk starts with its own header. A mapped one may have room for more than `blocks`.
+template<class Growth, class Stats, class Checks>
+auto BlockPool<Growth, Stats, Checks>::new_chunk(std::size_t blocks) -> Chunk* {
+    const auto region = chunk_memory::acquire(header_size_ + blocks * block_size_, block_align_, Growth::kHugePages);
+
+    auto* chunk = static_cast<Chunk*>(region.data);
+    chunk->next = nullptr;
+    chunk->prev = nullptr;
+    chunk->region = region;
+    stats_.on_chunk(region.bytes, region.mapped);
+    checks_.on_chunk(reinterpret_cast<std::byte*>(chunk) + header_size_, region.bytes - header_size_);
+    return chunk;
+}
+
+template<class Growth, class Stats, class Checks>
+void BlockPool<Growth, Stats, Checks>::delete_chunk(Chunk* chunk) noexcept {
+    stats_.on_chunk_release(chunk->region.bytes);
+    checks_.on_chunk_release(reinterpret_cast<std::byte*>(chunk) + header_size_, chunk->region.bytes - header_size_);
+    chunk_memory::release(chunk->region, block_align_);
+}
+
+template<class Growth, class Stats, class Checks>
+void BlockPool<Growth, Stats, Checks>::grow(std::size_t min_blocks) {
+    Chunk* chunk = new_chunk(std::max(next_chunk_blocks_, min_blocks));
+    chunk->next = chunks_;
+    chunks_ = chunk;
+    next_chunk_blocks_ = std::min(next_chunk_blocks_ * 2, max_chunk_blocks_);
+
+    // whatever is left of the previous chunk stays usable through the free lists
+    if (bump_ != bump_end_) {
+        give_back(bump_, static_cast<std::size_t>(bump_end_ - bump_) / block_size_);
+    }
+
+    const std::size_t blocks = (chunk->region.bytes - header_size_) / block_size_;
+    bump_ = reinterpret_cast<std::byte*>(chunk) + header_size_;
+    bump_end_ = bump_ + blocks * block_size_;
+    total_ += blocks;
+}
+
+// Pushes `blocks` contiguous blocks to the free lists, in pieces of at most kMaxRunBlocks.
+template<class Growth, class Stats, class Checks>
+void BlockPool<Growth, Stats, Checks>::give_back(std::byte* run, std::size_t blocks) noexcept {
+    while (blocks > 0) {
+        const std::size_t piece = std::min(blocks, kMaxRunBlocks);
+
+        checks_.on_link(run);
+        auto* node = reinterpret_cast<Node*>(run);
+        node->next = free_lists_[piece];
+        free_lists_[piece] = node;
+
+        run += piece * block_size_;
+        blocks -= piece;
+    }
+}
+
+template<class Growth, class Stats, class Checks>
+std::byte* BlockPool<Growth, Stats, Checks>::take_run(std::size_t blocks) {
+    if (Node* head = free_lists_[blocks]) {
+        free_lists_[blocks] = head->next;
+        return reinterpret_cast<std::byte*>(head);
+    }
+
+    if (static_cast<std::size_t>(bump_end_ - bump_) < blocks * block_size_) {
+        // split a longer freed run before asking for a new chunk
+        for (std::size_t longer = blocks + 1; longer <= kMaxRunBlocks; ++longer) {
+            if (Node* head = free_lists_[longer]) {
+                free_lists_[longer] = head->next;
+                auto* run = reinterpret_cast<std::byte*>(head);
+                give_back(run + blocks * block_size_, longer - blocks);
+                return run;
+            }
+        }
+
+        grow(blocks);
+    }
+
+    std::byte* run = bump_;
+    bump_ += blocks * block_size_;
+    return run;
+}
+
+template<class Growth, class Stats, class Checks>
+void* BlockPool<Growth, Stats, Checks>::allocate(std::size_t blocks) {
+    // fast path: one block off the free list
+    if (blocks == 1 && free_lists_[1]) {
+        Node* head = free_lists_[1];
+        free_lists_[1] = head->next;
+        ++used_;
+        stats_.on_allocate(1, used_);
+        checks_.on_allocate(head, block_size_);
+        return head;
+    }
+
+    if (blocks > kMaxRunBlocks) {
+        return allocate_dedicated(blocks);
+    }
+
+    std::byte* run = take_run(blocks);
+    used_ += blocks;
+    stats_.on_allocate(blocks, used_);
+    checks_.on_allocate(run, blocks * block_size_);
+    return run;
+}
+
+template<class Growth, class Stats, class Checks>
+void BlockPool<Growth, Stats, Checks>::deallocate(void* p, std::size_t blocks) noexcept {
+    stats_.on_deallocate(blocks);
+    checks_.on_deallocate(p, blocks * block_size_);
+
+    if (blocks > kMaxRunBlocks) {
+        deallocate_dedicated(p, blocks);
+        return;
+    }
+
+    auto* node = static_cast<Node*>(p);
+    node->next = free_lists_[blocks];
+    free_lists_[blocks] = node;
+
+    used_ -= blocks;
+}
+
+template<class Growth, class Stats, class Checks>
+void* BlockPool<Growth, Stats, Checks>::allocate_dedicated(std::size_t blocks) {
+    Chunk* chunk = new_chunk(blocks);
+    chunk->next = dedicated_;
+    if (dedicated_) dedicated_->prev = chunk;
+    dedicated_ = chunk;
+
+    total_ += blocks;
+    used_ += blocks;
+    stats_.on_fallback();
+    stats_.on_allocate(blocks, used_);
+
+    void* run = reinterpret_cast<std::byte*>(chunk) + header_size_;
+    checks_.on_allocate(run, blocks * block_size_);
+    return run;
+}
+
+template<class Growth, class Stats, class Checks>
+void BlockPool<Growth, Stats, Checks>::deallocate_dedicated(void* p, std::size_t blocks) noexcept {
+    auto* chunk = reinterpret_cast<Chunk*>(static_cast<std::byte*>(p) - header_size_);
+    if (chunk->prev) chunk->prev->next = chunk->next;
+    else dedicated_ = chunk->next;
+    if (chunk->next) chunk->next->prev = chunk->prev;
+
+    delete_chunk(chunk);
+    total_ -= blocks;
+    used_ -= blocks;
+}
+
+template<class Growth, class Stats, class Checks>
+void BlockPool<Growth, Stats, Checks>::release_all() noexcept {
+    for (Chunk* list : {chunks_, dedicated_}) {
+        while (list) {
+            Chunk* next = list->next;
+            delete_chunk(list);
+            list = next;
+        }
+    }
+    chunks_ = dedicated_ = nullptr;
+    checks_.on_release();
+    free_lists_.fill(nullptr);
+    bump_ = bump_end_ = nullptr;
+    next_chunk_blocks_ = Growth::kFirstChunkBlocks;
+    used_ = total_ = 0;
+}
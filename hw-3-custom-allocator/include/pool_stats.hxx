@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Statistics policies for BlockPool and ExpandablePoolAllocator.
+//
+// NoPoolStats is empty and its hooks do nothing, so a pool built with it
+// compiles to the same code as one without statistics. PoolStats counts:
+// - allocations and deallocations;
+// - the high-water mark of used blocks;
+// - live and peak chunks, and how many of them were mmapped;
+// - bytes asked for against bytes handed out in blocks, the difference
+//   being what block rounding wastes;
+// - heap fallbacks, i.e. runs longer than BlockPool::kMaxRunBlocks that
+//   got a chunk of their own;
+// - a histogram of request sizes in power-of-two buckets.
+struct NoPoolStats {
+    static constexpr bool kEnabled = false;
+
+    void on_request(std::size_t, std::size_t) noexcept {}
+    void on_allocate(std::size_t, std::size_t) noexcept {}
+    void on_deallocate(std::size_t) noexcept {}
+    void on_split(std::size_t) noexcept {}
+    void on_fallback() noexcept {}
+    void on_chunk(std::size_t, bool) noexcept {}
+    void on_chunk_release(std::size_t) noexcept {}
+};
+
+class PoolStats {
+public:
+    static constexpr bool kEnabled = true;
+
+    // bucket k counts requests of (2^(k-1), 2^k] bytes, the last one everything bigger
+    static constexpr std::size_t kHistogramBuckets = 32;
+
+    // `requested` bytes asked for, `granted` bytes of blocks handed out for them
+    void on_request(std::size_t requested, std::size_t granted) noexcept {
+        requested_bytes_ += requested;
+        granted_bytes_ += granted;
+        ++histogram_[bucket_of(requested)];
+    }
+
+    // `used` is the pool's used block count after the allocation
+    void on_allocate(std::size_t, std::size_t used) noexcept {
+        ++allocations_;
+        peak_used_blocks_ = std::max<std::uint64_t>(peak_used_blocks_, used);
+    }
+
+    void on_deallocate(std::size_t) noexcept { ++deallocations_; }
+
+    // the last allocation is a run of `pieces` objects to be freed one by one
+    void on_split(std::size_t pieces) noexcept { allocations_ += pieces - 1; }
+    void on_fallback() noexcept { ++fallbacks_; }
+
+    void on_chunk(std::size_t bytes, bool mapped) noexcept {
+        ++chunks_;
+        ++chunks_created_;
+        chunk_bytes_ += bytes;
+        if (mapped) ++mapped_chunks_created_;
+        peak_chunks_ = std::max(peak_chunks_, chunks_);
+        peak_chunk_bytes_ = std::max(peak_chunk_bytes_, chunk_bytes_);
+    }
+
+    void on_chunk_release(std::size_t bytes) noexcept {
+        --chunks_;
+        chunk_bytes_ -= bytes;
+    }
+
+    [[nodiscard]] std::uint64_t allocations() const noexcept { return allocations_; }
+    [[nodiscard]] std::uint64_t deallocations() const noexcept { return deallocations_; }
+    [[nodiscard]] std::uint64_t peak_used_blocks() const noexcept { return peak_used_blocks_; }
+    [[nodiscard]] std::uint64_t chunks() const noexcept { return chunks_; }
+    [[nodiscard]] std::uint64_t peak_chunks() const noexcept { return peak_chunks_; }
+    [[nodiscard]] std::uint64_t chunk_bytes() const noexcept { return chunk_bytes_; }
+    [[nodiscard]] std::uint64_t peak_chunk_bytes() const noexcept { return peak_chunk_bytes_; }
+    [[nodiscard]] std::uint64_t requested_bytes() const noexcept { return requested_bytes_; }
+    [[nodiscard]] std::uint64_t granted_bytes() const noexcept { return granted_bytes_; }
+    [[nodiscard]] std::uint64_t wasted_bytes() const noexcept { return granted_bytes_ - requested_bytes_; }
+    [[nodiscard]] std::uint64_t fallbacks() const noexcept { return fallbacks_; }
+
+    [[nodiscard]] double fallback_rate() const noexcept {
+        return allocations_ ? static_cast<double>(fallbacks_) / static_cast<double>(allocations_) : 0.0;
+    }
+
+    [[nodiscard]] const std::array<std::uint64_t, kHistogramBuckets>& histogram() const noexcept { return histogram_; }
+
+    // one JSON object; empty histogram buckets are left out
+    void write_json(std::ostream& os) const {
+        os << "{\"allocations\":" << allocations_
+           << ",\"deallocations\":" << deallocations_
+           << ",\"peak_used_blocks\":" << peak_used_blocks_
+           << ",\"chunks\":" << chunks_
+           << ",\"peak_chunks\":" << peak_chunks_
+           << ",\"chunks_created\":" << chunks_created_
+           << ",\"mapped_chunks_created\":" << mapped_chunks_created_
+           << ",\"chunk_bytes\":" << chunk_bytes_
+           << ",\"peak_chunk_bytes\":" << peak_chunk_bytes_
+           << ",\"requested_bytes\":" << requested_bytes_
+           << ",\"granted_bytes\":" << granted_bytes_
+           << ",\"wasted_bytes\":" << wasted_bytes()
+           << ",\"fallbacks\":" << fallbacks_
+           << ",\"fallback_rate\":" << fallback_rate()
+           << ",\"size_histogram\":[";
+
+        bool first = true;
+        for (std::size_t k = 0; k < kHistogramBuckets; ++k) {
+            if (histogram_[k] == 0) continue;
+            os << (first ? "" : ",") << "{\"up_to_bytes\":";
+            if (k + 1 < kHistogramBuckets) os << (std::uint64_t{1} << k);
+            else os << "null";
+            os << ",\"count\":" << histogram_[k] << '}';
+            first = false;
+        }
+        os << "]}";
+    }
+
+private:
+    static constexpr std::size_t bucket_of(std::size_t bytes) noexcept {
+        return std::min<std::size_t>(std::bit_width(bytes > 0 ? bytes - 1 : 0), kHistogramBuckets - 1);
+    }
+
+    std::uint64_t allocations_ = 0;
+    std::uint64_t deallocations_ = 0;
+    std::uint64_t peak_used_blocks_ = 0;
+    std::uint64_t chunks_ = 0;
+    std::uint64_t peak_chunks_ = 0;
+    std::uint64_t chunks_created_ = 0;
+    std::uint64_t mapped_chunks_created_ = 0;
+    std::uint64_t chunk_bytes_ = 0;
+    std::uint64_t peak_chunk_bytes_ = 0;
+    std::uint64_t requested_bytes_ = 0;
+    std::uint64_t granted_bytes_ = 0;
+    std::uint64_t fallbacks_ = 0;
+    std::array<std::uint64_t, kHistogramBuckets> histogram_{};
+};
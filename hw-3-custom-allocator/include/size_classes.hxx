@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// Size classes shared by all types that allocate from one PoolResource in
+// size-classed mode (see kSizeClassed below). A class is
+// aligned to the largest power of two dividing its size, capped at
+// alignof(std::max_align_t), so a 40-byte map node and a 48-byte string
+// buffer both land in the 48-byte class.
+// BlockSize that puts an allocator in size-classed mode
+inline constexpr std::size_t kSizeClassed = 0;
+
+namespace size_classes {
+
+inline constexpr std::array<std::size_t, 11> kSizes{8, 16, 32, 48, 64, 96, 128, 192, 256, 384, 512};
+inline constexpr std::size_t kCount = kSizes.size();
+inline constexpr std::size_t kMaxSize = kSizes.back();
+
+constexpr std::size_t align_of(std::size_t size) noexcept {
+    return std::min(alignof(std::max_align_t), size & (~size + 1));
+}
+
+namespace detail {
+
+// smallest class index for every size in 8-byte steps, [0] for 0 bytes
+inline constexpr auto kIndexByEighth = [] {
+    std::array<unsigned char, kMaxSize / 8 + 1> table{};
+    std::size_t index = 0;
+    for (std::size_t eighth = 0; eighth < table.size(); ++eighth) {
+        while (kSizes[index] < eighth * 8) ++index;
+        table[eighth] = static_cast<unsigned char>(index);
+    }
+    return table;
+}();
+
+} // namespace detail
+
+// index of the smallest class that holds `bytes` at `align`, kCount if none does
+constexpr std::size_t index_of(std::size_t bytes, std::size_t align) noexcept {
+    if (bytes > kMaxSize) return kCount;
+    std::size_t index = detail::kIndexByEighth[(bytes + 7) / 8];
+    while (index < kCount && align_of(kSizes[index]) < align) ++index;
+    return index;
+}
+
+} // namespace size_classes
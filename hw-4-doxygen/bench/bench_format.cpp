@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <ostream>
+#include <random>
+#include <span>
+#include <streambuf>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "src/print_ip.h"
+
+// The iostream loop print_ip used before format_ip, against format_ips into
+// one buffer and write_ips to /dev/null.
+
+namespace {
+
+// a streambuf that drops everything, so only the formatting is measured
+class NullBuf : public std::streambuf {
+protected:
+    int_type overflow(int_type ch) override { return ch; }
+    std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+};
+
+std::vector<std::uint32_t> make_addresses(std::size_t count) {
+    std::mt19937 rng(42);
+    std::vector<std::uint32_t> addresses(count);
+    for (auto &address : addresses) address = static_cast<std::uint32_t>(rng());
+    return addresses;
+}
+
+void stream_ip(std::ostream &out, std::uint32_t value) {
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        const auto shift = (sizeof(value) - 1 - i) * 8;
+        const unsigned int byte = (value >> shift) & 0xFF;
+        out << byte << (i == sizeof(value) - 1 ? "" : ".");
+    }
+    out << "\n";
+}
+
+void BM_StreamIps(benchmark::State &state) {
+    const auto addresses = make_addresses(static_cast<std::size_t>(state.range(0)));
+    NullBuf buf;
+    std::ostream out(&buf);
+
+    for (auto _ : state) {
+        for (const auto address : addresses) stream_ip(out, address);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_FormatIps(benchmark::State &state) {
+    const auto addresses = make_addresses(static_cast<std::size_t>(state.range(0)));
+    std::string text;
+
+    for (auto _ : state) {
+        text.clear();
+        format_ips(std::span(addresses), text);
+        benchmark::DoNotOptimize(text.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+void BM_WriteIps(benchmark::State &state) {
+    const auto addresses = make_addresses(static_cast<std::size_t>(state.range(0)));
+    const int fd = ::open("/dev/null", O_WRONLY);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(write_ips(std::span(addresses), fd));
+    }
+
+    ::close(fd);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_StreamIps)->RangeMultiplier(100)->Range(1'000, 10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FormatIps)->RangeMultiplier(100)->Range(1'000, 10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WriteIps)->RangeMultiplier(100)->Range(1'000, 10'000'000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "src/print_ips.h"
+
+// print_ips to /dev/null from 1 thread up to one per core, for 10M
+// addresses as uint32 and as std::array<int, 4>.
+
+namespace {
+
+template<class T>
+std::vector<T> make_addresses(std::size_t count) {
+    std::mt19937 rng(42);
+    std::vector<T> values(count);
+    for (auto &value : values) {
+        if constexpr (std::is_integral_v<T>) {
+            value = static_cast<T>(rng());
+        } else {
+            for (auto &octet : value) octet = static_cast<int>(rng() & 0xFF);
+        }
+    }
+    return values;
+}
+
+template<class T>
+void BM_PrintIps(benchmark::State &state) {
+    static const auto values = make_addresses<T>(10'000'000);
+    const int fd = ::open("/dev/null", O_WRONLY);
+
+    for (auto _ : state) {
+        if (!print_ips(values, fd, static_cast<unsigned>(state.range(0)))) state.SkipWithError("write failed");
+    }
+
+    ::close(fd);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(values.size()));
+}
+
+void all_cores(benchmark::internal::Benchmark *bench) {
+    const auto cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; threads < cores; threads *= 2) bench->Arg(threads);
+    bench->Arg(cores);
+}
+
+} // namespace
+
+BENCHMARK(BM_PrintIps<std::uint32_t>)->Apply(all_cores)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PrintIps<std::array<int, 4>>)->Apply(all_cores)->Unit(benchmark::kMillisecond)->UseRealTime();
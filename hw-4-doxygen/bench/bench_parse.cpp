@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <arpa/inet.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "src/parse_ip.h"
+
+// parse_ip against inet_pton on dotted-quad text produced by format_ip.
+// Before timing, every benchmark checks that parse_ip(format_ip(x)) == x
+// for its values and, for IPv4, that inet_pton returns the same address.
+
+namespace {
+
+static_assert(ip_literal<std::uint32_t>("127.0.0.1") == 0x7F000001u);
+static_assert(ip_literal<std::int8_t>("255") == -1);
+static_assert(ip_literal<std::tuple<int, int, int>>("123.456.789") == std::tuple{123, 456, 789});
+static_assert(parse_ip<std::uint32_t>("1.2.3.256").error() == ParseIpError::OutOfRange);
+static_assert(parse_ip<std::uint32_t>("1.02.3.4").error() == ParseIpError::NotANumber);
+static_assert(parse_ip<std::uint32_t>("1.2.3").error() == ParseIpError::WrongCount);
+
+using Quad = std::tuple<int, int, int, int>;
+
+template<class T>
+std::vector<T> make_values(std::size_t count) {
+    std::mt19937_64 rng(42);
+    std::vector<T> values(count);
+    for (auto &value : values) {
+        if constexpr (std::is_integral_v<T>) {
+            value = static_cast<T>(rng());
+        } else {
+            value = {static_cast<int>(rng() & 0xFF), static_cast<int>(rng() & 0xFF),
+                     static_cast<int>(rng() & 0xFF), static_cast<int>(rng() & 0xFF)};
+        }
+    }
+    return values;
+}
+
+// the text of each value, NUL-terminated for inet_pton
+template<class T>
+std::vector<std::string> make_texts(const std::vector<T> &values) {
+    std::vector<std::string> texts;
+    texts.reserve(values.size());
+    for (const auto &value : values) {
+        std::string text;
+        format_ip(value, text);
+        texts.push_back(std::move(text));
+    }
+    return texts;
+}
+
+template<class T>
+bool round_trips(const std::vector<T> &values, const std::vector<std::string> &texts) {
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        const auto parsed = parse_ip<T>(texts[i]);
+        if (!parsed || *parsed != values[i]) return false;
+    }
+    return true;
+}
+
+template<class T>
+void BM_ParseIp(benchmark::State &state) {
+    const auto values = make_values<T>(static_cast<std::size_t>(state.range(0)));
+    const auto texts = make_texts(values);
+    if (!round_trips(values, texts)) {
+        state.SkipWithError("parse_ip(format_ip(x)) != x");
+        return;
+    }
+
+    for (auto _ : state) {
+        for (const auto &text : texts) benchmark::DoNotOptimize(parse_ip<T>(text));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_InetPton(benchmark::State &state) {
+    const auto values = make_values<std::uint32_t>(static_cast<std::size_t>(state.range(0)));
+    const auto texts = make_texts(values);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        in_addr address{};
+        if (::inet_pton(AF_INET, texts[i].c_str(), &address) != 1 || ntohl(address.s_addr) != values[i]) {
+            state.SkipWithError("inet_pton disagrees with format_ip");
+            return;
+        }
+    }
+
+    for (auto _ : state) {
+        for (const auto &text : texts) {
+            in_addr address{};
+            benchmark::DoNotOptimize(::inet_pton(AF_INET, text.c_str(), &address));
+            benchmark::DoNotOptimize(address);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_InetPton)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseIp<std::uint32_t>)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseIp<std::int64_t>)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseIp<Quad>)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
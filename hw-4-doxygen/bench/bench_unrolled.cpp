@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "bench/legacy_format.hpp"
+#include "src/print_ip.h"
+
+// Compile-time unrolled format_ip against the runtime-loop version, one
+// address per call into a stack buffer of kMaxIpLength.
+
+namespace {
+
+using Quad = std::tuple<int, int, int, int>;
+
+template<class T>
+std::vector<T> make_values(std::size_t count) {
+    std::mt19937_64 rng(42);
+    std::vector<T> values(count);
+    for (auto &value : values) {
+        if constexpr (std::is_integral_v<T>) {
+            value = static_cast<T>(rng());
+        } else {
+            value = {static_cast<int>(rng() & 0xFF), static_cast<int>(rng() & 0xFF),
+                     static_cast<int>(rng() & 0xFF), static_cast<int>(rng() & 0xFF)};
+        }
+    }
+    return values;
+}
+
+struct Legacy {
+    template<class T> static char *format(const T &value, char *out) { return legacy::format_ip(value, out); }
+};
+
+struct Unrolled {
+    template<class T> static char *format(const T &value, char *out) { return format_ip(value, out); }
+};
+
+template<class Impl, class T>
+void BM_FormatOne(benchmark::State &state) {
+    const auto values = make_values<T>(4096);
+    char line[kMaxIpLength<T>];
+    std::size_t bytes = 0;
+
+    for (auto _ : state) {
+        for (const auto &value : values) {
+            char *end = Impl::format(value, line);
+            bytes += static_cast<std::size_t>(end - line);
+            benchmark::DoNotOptimize(line);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(values.size()));
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+}
+
+} // namespace
+
+BENCHMARK(BM_FormatOne<Legacy, std::uint32_t>);
+BENCHMARK(BM_FormatOne<Unrolled, std::uint32_t>);
+BENCHMARK(BM_FormatOne<Legacy, std::uint64_t>);
+BENCHMARK(BM_FormatOne<Unrolled, std::uint64_t>);
+BENCHMARK(BM_FormatOne<Legacy, Quad>);
+BENCHMARK(BM_FormatOne<Unrolled, Quad>);
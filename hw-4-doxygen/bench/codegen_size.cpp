@@ -0,0 +1,21 @@
+#include <cstdint>
+#include <tuple>
+
+#include "bench/legacy_format.hpp"
+#include "src/print_ip.h"
+
+// One out-of-line instantiation per formatting path, so that
+// `nm --print-size` on this object shows what each of them costs in code.
+// Built and listed by the print_ip_codegen_size target.
+
+using Quad = std::tuple<int, int, int, int>;
+
+#define PRINT_IP_INSTANCE(name, impl, type) \
+    extern "C" [[gnu::noinline]] char *name(const type &value, char *out) { return impl(value, out); }
+
+PRINT_IP_INSTANCE(legacy_format_u32, legacy::format_ip, std::uint32_t)
+PRINT_IP_INSTANCE(unrolled_format_u32, format_ip, std::uint32_t)
+PRINT_IP_INSTANCE(legacy_format_u64, legacy::format_ip, std::uint64_t)
+PRINT_IP_INSTANCE(unrolled_format_u64, format_ip, std::uint64_t)
+PRINT_IP_INSTANCE(legacy_format_quad, legacy::format_ip, Quad)
+PRINT_IP_INSTANCE(unrolled_format_quad, format_ip, Quad)
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "src/print_ip.h"
+
+// format_ip as it was before the compile-time paths: a runtime loop over
+// the bytes of an integer and std::apply with a counter for tuples. Kept
+// for the throughput and code size comparisons only.
+
+namespace legacy {
+
+template<std::integral T>
+char *format_ip(T value, char *out) noexcept {
+    using U = std::make_unsigned_t<T>;
+
+    const U unsigned_val = static_cast<U>(value);
+    constexpr std::size_t bytes_count = sizeof(T);
+
+    for (std::size_t i = 0; i < bytes_count; ++i) {
+        const auto &octet = kOctetDigits[(unsigned_val >> ((bytes_count - 1 - i) * 8)) & 0xFF];
+        if (i != 0) *out++ = '.';
+        out = std::copy_n(octet.text.data(), octet.length, out);
+    }
+
+    return out;
+}
+
+template<HomogeneousTuple T>
+char *format_ip(const T &tpl, char *out) {
+    std::apply([&out](const auto &...args) {
+        std::size_t n = 0;
+        ((out = (n++ == 0 ? out : (*out = '.', out + 1)), out = detail::format_element(args, out)), ...);
+    }, tpl);
+
+    return out;
+}
+
+} // namespace legacy
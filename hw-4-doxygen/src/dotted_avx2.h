@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PRINT_IP_HAS_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace detail {
+
+/**
+ * @brief Маска pshufb, собирающая 4 октета в текст, и длина этого текста.
+ */
+struct DottedShuffle {
+    std::array<char, 16> mask; ///< Индексы байтов внутри 128-битной половины регистра.
+    std::uint8_t length;       ///< Длина текста вместе с разделителем после последнего октета.
+};
+
+/**
+ * @brief Маски для всех сочетаний длин октетов, строятся при компиляции.
+ *
+ * Октет `k` (от младшего) лежит в байтах [4k, 4k + 3] как сотни, десятки,
+ * единицы и разделитель. Биты 0..3 индекса: октет `k` не меньше 10, биты
+ * 4..7: не меньше 100. Маска берёт октеты от старшего к младшему и у
+ * каждого только значащие цифры.
+ */
+inline constexpr auto kDottedShuffles = [] {
+    std::array<DottedShuffle, 256> table{};
+
+    for (int index = 0; index < 256; ++index) {
+        auto& entry = table[static_cast<std::size_t>(index)];
+        entry.mask.fill(static_cast<char>(0x80));
+
+        std::size_t at = 0;
+        for (int slot = 3; slot >= 0; --slot) {
+            const int length = 1 + ((index >> slot) & 1) + ((index >> (slot + 4)) & 1);
+            for (int digit = 3 - length; digit < 3; ++digit) entry.mask[at++] = static_cast<char>(slot * 4 + digit);
+            entry.mask[at++] = static_cast<char>(slot * 4 + 3);
+        }
+        entry.length = static_cast<std::uint8_t>(at);
+    }
+
+    return table;
+}();
+
+#ifdef PRINT_IP_HAS_AVX2_KERNEL
+
+/**
+ * @brief Переводит в текст группы по 4 четырёхбайтных слова, по 16 байт за шаг.
+ *
+ * Цифры всех 16 октетов считаются сразу: сотни и десятки через умножение
+ * на обратную величину, без деления. Затем по маске из kDottedShuffles
+ * каждое слово сжимается в "a.b.c.d" и пишется одним 16-байтным store.
+ *
+ * Для `Wide` слова идут парами, как половины uint64: старшая половина
+ * пишется первой и заканчивается точкой, младшая — переводом строки.
+ *
+ * @param bytes Слова в порядке little-endian.
+ * @param words Количество слов, кратное 4.
+ * @param out Буфер не меньше 16 байт на слово: store пишет целый регистр.
+ * @return Указатель за последним значащим символом.
+ */
+template<bool Wide>
+__attribute__((target("avx2")))
+inline char* format_dotted_avx2(const unsigned char* bytes, std::size_t words, char* out) noexcept {
+    const __m256i ascii_zero = _mm256_set1_epi16('0');
+    // разделитель после октета в старшем байте каждого 16-битного слова
+    const __m256i separators = Wide
+        ? _mm256_setr_epi16('\n' << 8, '.' << 8, '.' << 8, '.' << 8, '.' << 8, '.' << 8, '.' << 8, '.' << 8,
+                            '\n' << 8, '.' << 8, '.' << 8, '.' << 8, '.' << 8, '.' << 8, '.' << 8, '.' << 8)
+        : _mm256_setr_epi16('\n' << 8, '.' << 8, '.' << 8, '.' << 8, '\n' << 8, '.' << 8, '.' << 8, '.' << 8,
+                            '\n' << 8, '.' << 8, '.' << 8, '.' << 8, '\n' << 8, '.' << 8, '.' << 8, '.' << 8);
+
+    auto emit = [&out](__m128i text, unsigned index) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), text);
+        out += kDottedShuffles[index].length;
+    };
+    auto shuffle = [](unsigned index) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(kDottedShuffles[index].mask.data()));
+    };
+
+    for (std::size_t word = 0; word + 4 <= words; word += 4, bytes += 16) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+        const __m256i octets = _mm256_cvtepu8_epi16(raw);
+
+        const __m256i hundreds = _mm256_mulhi_epu16(octets, _mm256_set1_epi16(656));
+        const __m256i rest = _mm256_sub_epi16(octets, _mm256_mullo_epi16(hundreds, _mm256_set1_epi16(100)));
+        const __m256i tens = _mm256_mulhi_epu16(rest, _mm256_set1_epi16(6554));
+        const __m256i ones = _mm256_sub_epi16(rest, _mm256_mullo_epi16(tens, _mm256_set1_epi16(10)));
+
+        const __m256i high = _mm256_or_si256(_mm256_add_epi16(hundreds, ascii_zero),
+                                             _mm256_slli_epi16(_mm256_add_epi16(tens, ascii_zero), 8));
+        const __m256i low = _mm256_or_si256(_mm256_add_epi16(ones, ascii_zero), separators);
+
+        // половины регистров: слова 0 | 2 и 1 | 3
+        const __m256i even = _mm256_unpacklo_epi16(high, low);
+        const __m256i odd = _mm256_unpackhi_epi16(high, low);
+
+        const auto ge10 = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(raw, _mm_set1_epi8(9)), raw)));
+        const auto ge100 = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(raw, _mm_set1_epi8(99)), raw)));
+        unsigned index[4];
+        for (unsigned i = 0; i < 4; ++i) index[i] = ((ge10 >> (4 * i)) & 0xF) | (((ge100 >> (4 * i)) & 0xF) << 4);
+
+        const __m256i even_text = _mm256_shuffle_epi8(even, _mm256_set_m128i(shuffle(index[2]), shuffle(index[0])));
+        const __m256i odd_text = _mm256_shuffle_epi8(odd, _mm256_set_m128i(shuffle(index[3]), shuffle(index[1])));
+
+        if constexpr (Wide) {
+            emit(_mm256_castsi256_si128(odd_text), index[1]);
+            emit(_mm256_castsi256_si128(even_text), index[0]);
+            emit(_mm256_extracti128_si256(odd_text, 1), index[3]);
+            emit(_mm256_extracti128_si256(even_text, 1), index[2]);
+        } else {
+            emit(_mm256_castsi256_si128(even_text), index[0]);
+            emit(_mm256_castsi256_si128(odd_text), index[1]);
+            emit(_mm256_extracti128_si256(even_text, 1), index[2]);
+            emit(_mm256_extracti128_si256(odd_text, 1), index[3]);
+        }
+    }
+
+    return out;
+}
+
+/**
+ * @brief Проверяет, что процессор поддерживает AVX2; проверка выполняется один раз.
+ */
+inline bool has_avx2_formatter() noexcept {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#else
+
+template<bool Wide>
+inline char* format_dotted_avx2(const unsigned char*, std::size_t, char* out) noexcept {
+    return out;
+}
+
+inline bool has_avx2_formatter() noexcept {
+    return false;
+}
+
+#endif
+
+} // namespace detail
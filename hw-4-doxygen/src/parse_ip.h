@@ -0,0 +1,279 @@
+#pragma once
+
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "src/print_ip.h"
+
+/**
+ * @brief Причина, по которой текст не разобран как IP-адрес.
+ */
+enum class ParseIpError {
+    NotANumber,  ///< Пустая часть, не цифра или лишний ведущий ноль.
+    OutOfRange,  ///< Октет больше 255 или число не помещается в тип элемента.
+    WrongCount,  ///< Частей больше или меньше, чем нужно типу, или текст после адреса.
+};
+
+namespace detail {
+
+/**
+ * @brief Целое, которое parse_ip умеет читать как элемент контейнера или кортежа.
+ *
+ * Символьные типы print_ip выводит символом, такой текст однозначно не разобрать.
+ */
+template<typename E>
+concept ParsableElement = std::integral<E> && !CharElement<E> && !std::same_as<E, bool>;
+
+/**
+ * @brief Четыре байта текста, начиная с `p`, в порядке little-endian;
+ * байты за `end` нулевые.
+ */
+constexpr std::uint32_t load_word(const char* p, const char* end) noexcept {
+    if !consteval {
+        if (end - p >= 4) {
+            std::uint32_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if constexpr (std::endian::native == std::endian::big) word = std::byteswap(word);
+            return word;
+        }
+    }
+
+    std::uint32_t word = 0;
+    for (int i = 0; i < 4 && p + i < end; ++i) word |= static_cast<std::uint32_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+    return word;
+}
+
+/**
+ * @brief Читает `Octets` десятичных октетов через точку, от старшего к младшему.
+ *
+ * Ветвлений по символам нет: длина октета берётся из маски нецифр,
+ * посчитанной сразу по четырём байтам, значение — тремя умножениями, а
+ * ошибки копятся флагами и проверяются один раз в конце.
+ */
+template<std::size_t Octets>
+constexpr std::expected<std::uint64_t, ParseIpError> parse_octets(std::string_view text) noexcept {
+    const char* p = text.data();
+    const char* const end = p + text.size();
+
+    std::uint64_t bits = 0;
+    bool not_a_number = false;
+    bool out_of_range = false;
+    bool wrong_count = false;
+
+    for (std::size_t i = 0; i < Octets; ++i) {
+        const std::uint32_t word = load_word(p, end);
+        const std::uint32_t digits = word - 0x30303030u;
+        // старший бит байта поднят у всего, что не '0'..'9'
+        const std::uint32_t non_digits = ((word + 0x46464646u) | digits) & 0x80808080u;
+        const auto length = static_cast<std::size_t>(std::countr_zero(non_digits) / 8);
+
+        const std::uint32_t d0 = digits & 0xFF;
+        const std::uint32_t d1 = (digits >> 8) & 0xFF;
+        const std::uint32_t d2 = (digits >> 16) & 0xFF;
+        const std::uint32_t value = length == 1 ? d0 : length == 2 ? d0 * 10 + d1 : d0 * 100 + d1 * 10 + d2;
+
+        not_a_number |= length == 0 || (length > 1 && d0 == 0);
+        out_of_range |= length > 3 || value > 255;
+
+        p += std::min<std::size_t>(length, static_cast<std::size_t>(end - p));
+        if (i + 1 < Octets) {
+            wrong_count |= p == end || *p != '.';
+            p += p != end;
+        }
+
+        bits = (bits << 8) | (value & 0xFF);
+        if (not_a_number || out_of_range || wrong_count) break;
+    }
+    wrong_count |= p != end;
+
+    if (not_a_number) return std::unexpected(ParseIpError::NotANumber);
+    if (out_of_range) return std::unexpected(ParseIpError::OutOfRange);
+    if (wrong_count) return std::unexpected(ParseIpError::WrongCount);
+    return bits;
+}
+
+/**
+ * @brief Читает десятичное целое типа `E` без ведущих нулей, со знаком для знаковых типов.
+ */
+template<ParsableElement E>
+constexpr std::expected<E, ParseIpError> parse_element(std::string_view text) noexcept {
+    const bool negative = std::is_signed_v<E> && !text.empty() && text.front() == '-';
+    const std::string_view digits = text.substr(negative ? 1 : 0);
+
+    if (digits.empty() || (digits.front() == '0' && (digits.size() > 1 || negative))) {
+        return std::unexpected(ParseIpError::NotANumber);
+    }
+
+    if !consteval {
+        E value{};
+        const auto [ptr, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error == std::errc::result_out_of_range) return std::unexpected(ParseIpError::OutOfRange);
+        if (error != std::errc{} || ptr != text.data() + text.size()) return std::unexpected(ParseIpError::NotANumber);
+        return value;
+    }
+
+    using U = std::make_unsigned_t<E>;
+    const U limit = negative ? static_cast<U>(static_cast<U>(std::numeric_limits<E>::max()) + 1)
+                             : static_cast<U>(std::numeric_limits<E>::max());
+    U magnitude = 0;
+    for (const char c : digits) {
+        const auto digit = static_cast<unsigned>(c - '0');
+        if (digit > 9) return std::unexpected(ParseIpError::NotANumber);
+        if (magnitude > (limit - digit) / 10) return std::unexpected(ParseIpError::OutOfRange);
+        magnitude = static_cast<U>(magnitude * 10 + digit);
+    }
+
+    return negative ? static_cast<E>(static_cast<U>(0) - magnitude) : static_cast<E>(magnitude);
+}
+
+/**
+ * @brief Читает элементы кортежа или std::array через точку.
+ */
+template<typename T>
+constexpr std::expected<T, ParseIpError> parse_fixed(std::string_view text) noexcept {
+    constexpr std::size_t count = std::tuple_size_v<T>;
+    T result{};
+
+    if constexpr (count == 0) {
+        if (!text.empty()) return std::unexpected(ParseIpError::WrongCount);
+    } else {
+        std::expected<void, ParseIpError> status;
+        auto read = [&]<std::size_t I>(std::integral_constant<std::size_t, I>) {
+            if (!status) return;
+
+            // за каждой частью, кроме последней, должна идти точка
+            const auto dot = text.find('.');
+            if ((I + 1 < count) == (dot == std::string_view::npos)) {
+                status = std::unexpected(ParseIpError::WrongCount);
+                return;
+            }
+
+            const auto element = parse_element<std::tuple_element_t<I, T>>(text.substr(0, dot));
+            if (!element) {
+                status = std::unexpected(element.error());
+                return;
+            }
+
+            std::get<I>(result) = *element;
+            text.remove_prefix(I + 1 < count ? dot + 1 : text.size());
+        };
+
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (read(std::integral_constant<std::size_t, I>{}), ...);
+        }(std::make_index_sequence<count>{});
+
+        if (!status) return std::unexpected(status.error());
+    }
+
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Разбирает IP-адрес в целочисленный тип: обратное к print_ip.
+ *
+ * Ждёт ровно `sizeof(T)` октетов 0..255 через точку, без знаков, пробелов
+ * и ведущих нулей. Для знакового `T` октеты задают биты, так что "255"
+ * для int8_t даёт -1.
+ *
+ * @tparam T Целочисленный тип.
+ * @param text Текст IP-адреса.
+ * @return Значение или причина ошибки.
+ */
+template<std::integral T>
+constexpr std::expected<T, ParseIpError> parse_ip(std::string_view text) noexcept {
+    const auto bits = detail::parse_octets<sizeof(T)>(text);
+    if (!bits) return std::unexpected(bits.error());
+
+    return static_cast<T>(static_cast<std::make_unsigned_t<T>>(*bits));
+}
+
+/**
+ * @brief Строку print_ip выводит как есть, так же её и разбирает.
+ *
+ * @tparam T Строкоподобный тип.
+ * @param text Текст IP-адреса.
+ * @return Строка с текстом.
+ */
+template<StringLike T>
+constexpr std::expected<T, ParseIpError> parse_ip(std::string_view text) {
+    return T(text);
+}
+
+/**
+ * @brief Разбирает IP-адрес в контейнер целых: элементы через точку.
+ *
+ * У std::array число элементов должно совпасть с размером; vector, list и
+ * другие контейнеры с push_back берут сколько есть, пустой текст даёт
+ * пустой контейнер.
+ *
+ * @tparam T Контейнер для IP-адреса.
+ * @param text Текст IP-адреса.
+ * @return Контейнер или причина ошибки.
+ */
+template<IpContainer T>
+    requires detail::ParsableElement<std::ranges::range_value_t<T>> &&
+             (HasTupleSize<T> || requires(T& container, std::ranges::range_value_t<T> value) { container.push_back(value); })
+constexpr std::expected<T, ParseIpError> parse_ip(std::string_view text) {
+    if constexpr (HasTupleSize<T>) {
+        return detail::parse_fixed<T>(text);
+    } else {
+        T container;
+        if (text.empty()) return container;
+
+        for (;;) {
+            const auto dot = text.find('.');
+            const auto element = detail::parse_element<std::ranges::range_value_t<T>>(text.substr(0, dot));
+            if (!element) return std::unexpected(element.error());
+
+            container.push_back(*element);
+            if (dot == std::string_view::npos) return container;
+            text.remove_prefix(dot + 1);
+        }
+    }
+}
+
+/**
+ * @brief Разбирает IP-адрес в однородный кортеж целых.
+ *
+ * @tparam T Однородный кортеж.
+ * @param text Текст IP-адреса.
+ * @return Кортеж или причина ошибки.
+ */
+template<HomogeneousTuple T>
+    requires (std::tuple_size_v<T> == 0 || detail::ParsableElement<std::tuple_element_t<0, T>>)
+constexpr std::expected<T, ParseIpError> parse_ip(std::string_view text) noexcept {
+    return detail::parse_fixed<T>(text);
+}
+
+/**
+ * @brief IP-адрес из литерала, разобранный и проверенный при компиляции.
+ *
+ * Ошибка в литерале — ошибка компиляции:
+ * @code
+ * constexpr auto localhost = ip_literal<std::uint32_t>("127.0.0.1");
+ * @endcode
+ *
+ * @tparam T Целое, кортеж или std::array целых чисел.
+ * @param text Текст IP-адреса.
+ * @return Значение адреса.
+ */
+template<FixedLengthIp T>
+consteval T ip_literal(std::string_view text) {
+    const auto value = parse_ip<T>(text);
+    if (!value) throw "ip_literal: not a valid address for this type";
+    return *value;
+}
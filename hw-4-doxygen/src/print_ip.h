@@ -0,0 +1,595 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <unistd.h>
+
+#include "src/dotted_avx2.h"
+
+/**
+ * @brief Проверяет, поддерживает ли тип `T` размер кортежа.
+ *
+ * @tparam T Тип, который будет проверяться.
+ */
+template<typename T>
+concept HasTupleSize = requires {
+    std::tuple_size<std::remove_cvref_t<T>>::value;
+};
+
+/**
+ * @brief Проверяет однородность типов в кортеже.
+ *
+ * @tparam Tuple Кортеж, для которого будет проверяться однородность типов.
+ * @tparam Is Индексы, используемые для проверки однородности.
+ * @return true, если все типы одинаковые; иначе false.
+ */
+template<typename Tuple, std::size_t... Is>
+consteval bool check_homogeneity(std::index_sequence<Is...>) {
+    using T0 = std::tuple_element_t<0, Tuple>;
+
+    return ((std::same_as<T0, std::tuple_element_t<Is, Tuple>>) && ...);
+}
+
+/**
+ * @brief Проверяет, является ли кортеж однородным.
+ *
+ * @tparam T Тип, который будет проверяться.
+ * @return true, если кортеж однородный; иначе false.
+ */
+template<typename T>
+consteval bool is_homogeneous_tuple() {
+    using RawT = std::remove_cvref_t<T>;
+    constexpr auto size = std::tuple_size_v<RawT>;
+
+    if constexpr (size == 0) {
+        return true;
+    } else {
+        return check_homogeneity<RawT>(std::make_index_sequence<size>{});
+    }
+}
+
+/**
+ * @brief Проверяет, является ли тип строкоподобным (например, std::string).
+ *
+ * @tparam T Проверяемый тип.
+ * @return true, если тип строкоподобный; иначе false.
+ */
+template<typename T>
+concept StringLike = std::same_as<std::remove_cvref_t<T>, std::string>;
+
+/**
+ * @brief Проверяет, является ли тип контейнером для IP-адресов.
+ *
+ * @tparam T Тип, который будет проверяться.
+ * @return true, если тип контейнер; иначе false.
+ */
+template <typename T>
+concept IpContainer =
+    std::ranges::range<T> &&
+    !StringLike<T>;
+
+/**
+ * @brief Проверяет, является ли тип однородным кортежем.
+ *
+ * @tparam T Тип, который будет проверяться.
+ * @return true, если тип однородный кортеж; иначе false.
+ */
+template <typename T>
+concept HomogeneousTuple =
+    !IpContainer<T> &&
+    !StringLike<T> &&
+    HasTupleSize<T> &&
+    (is_homogeneous_tuple<T>());
+
+/**
+ * @brief Десятичная запись одного октета.
+ */
+struct OctetDigits {
+    std::array<char, 3> text; ///< Цифры, значимы первые `length`.
+    std::uint8_t length;      ///< Количество цифр: от 1 до 3.
+};
+
+/**
+ * @brief Десятичные записи всех 256 значений октета, строятся при компиляции.
+ */
+inline constexpr auto kOctetDigits = [] {
+    std::array<OctetDigits, 256> table{};
+    for (int value = 0; value < 256; ++value) {
+        auto& entry = table[static_cast<std::size_t>(value)];
+        if (value >= 100) {
+            entry = {{static_cast<char>('0' + value / 100), static_cast<char>('0' + value / 10 % 10),
+                      static_cast<char>('0' + value % 10)}, 3};
+        } else if (value >= 10) {
+            entry = {{static_cast<char>('0' + value / 10), static_cast<char>('0' + value % 10), '\0'}, 2};
+        } else {
+            entry = {{static_cast<char>('0' + value), '\0', '\0'}, 1};
+        }
+    }
+    return table;
+}();
+
+namespace detail {
+
+/**
+ * @brief Элемент контейнера или кортежа, который умеет выводить format_ip:
+ * целое число или строка.
+ */
+template<typename E>
+concept IpElement =
+    std::integral<std::remove_cvref_t<E>> ||
+    std::convertible_to<const std::remove_cvref_t<E>&, std::string_view>;
+
+/**
+ * @brief Символьные типы `std::ostream` выводит как символ, а не как число.
+ */
+template<typename E>
+concept CharElement =
+    std::same_as<E, char> || std::same_as<E, signed char> || std::same_as<E, unsigned char>;
+
+/**
+ * @brief Наибольшая длина записи элемента.
+ */
+template<typename E>
+constexpr std::size_t element_size(const E& element) {
+    if constexpr (CharElement<E> || std::same_as<E, bool>) {
+        return 1;
+    } else if constexpr (std::integral<E>) {
+        return std::numeric_limits<E>::digits10 + 2; // знак и неполный старший разряд
+    } else {
+        return std::string_view(element).size();
+    }
+}
+
+/**
+ * @brief Пишет элемент так же, как его вывел бы `std::cout <<`.
+ *
+ * @return Указатель за последним записанным символом.
+ */
+template<typename E>
+char* format_element(const E& element, char* out) {
+    if constexpr (CharElement<E>) {
+        *out = static_cast<char>(element);
+        return out + 1;
+    } else if constexpr (std::same_as<E, bool>) {
+        *out = element ? '1' : '0';
+        return out + 1;
+    } else if constexpr (std::integral<E>) {
+        return std::to_chars(out, out + element_size(element), element).ptr;
+    } else {
+        const std::string_view text(element);
+        return std::copy(text.begin(), text.end(), out);
+    }
+}
+
+/**
+ * @brief Проверяет, что все элементы кортежа умеет выводить format_ip.
+ */
+template<typename T>
+consteval bool tuple_elements_formattable() {
+    using RawT = std::remove_cvref_t<T>;
+    if constexpr (std::tuple_size_v<RawT> == 0) {
+        return true;
+    } else {
+        return IpElement<std::tuple_element_t<0, RawT>>;
+    }
+}
+
+/**
+ * @brief Проверяет, что все элементы кортежа или std::array целые.
+ */
+template<typename T>
+consteval bool tuple_elements_integral() {
+    using RawT = std::remove_cvref_t<T>;
+    if constexpr (std::tuple_size_v<RawT> == 0) {
+        return true;
+    } else {
+        return std::integral<std::tuple_element_t<0, RawT>>;
+    }
+}
+
+/**
+ * @brief Наибольшая длина записи IP-адреса типа `T`, вычисляется при компиляции.
+ */
+template<typename T>
+consteval std::size_t max_ip_length() {
+    if constexpr (std::integral<T>) {
+        return sizeof(T) * 4 - 1;
+    } else {
+        constexpr std::size_t count = std::tuple_size_v<T>;
+        if constexpr (count == 0) {
+            return 0;
+        } else {
+            using E = std::tuple_element_t<0, T>;
+            return count * element_size(E{}) + count - 1;
+        }
+    }
+}
+
+/**
+ * @brief Пишет октет `I` целого, считая от старшего, с точкой перед ним.
+ *
+ * Все октеты, кроме последнего, копируются тремя байтами без ветвлений:
+ * лишние байты затрёт следующий октет, а за ним всегда есть ещё хотя бы
+ * точка и одна цифра.
+ */
+template<std::size_t I, typename U>
+constexpr char* put_octet(U value, char* out) noexcept {
+    constexpr std::size_t bytes_count = sizeof(U);
+    constexpr std::size_t shift = (bytes_count - 1 - I) * 8;
+
+    if constexpr (I != 0) *out++ = '.';
+    const auto& octet = kOctetDigits[(value >> shift) & 0xFF];
+
+    if constexpr (I + 1 < bytes_count) {
+        std::copy_n(octet.text.data(), 3, out);
+        return out + octet.length;
+    } else {
+        return std::copy_n(octet.text.data(), octet.length, out);
+    }
+}
+
+/**
+ * @brief Пишет элемент `I` кортежа, с точкой перед ним.
+ */
+template<std::size_t I, typename E>
+char* put_element(const E& element, char* out) {
+    if constexpr (I != 0) *out++ = '.';
+    return format_element(element, out);
+}
+
+/**
+ * @brief Пишет элементы кортежа или std::array через точку, цикл развёрнут при компиляции.
+ */
+template<typename T>
+char* format_fixed(const T& tpl, char* out) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((out = put_element<I>(std::get<I>(tpl), out)), ...);
+    }(std::make_index_sequence<std::tuple_size_v<T>>{});
+
+    return out;
+}
+
+} // namespace detail
+
+/**
+ * @brief Тип, у записи которого есть наибольшая длина, известная при
+ * компиляции: целое, а также кортеж или std::array целых чисел.
+ *
+ * @tparam T Тип, который будет проверяться.
+ */
+template<typename T>
+concept FixedLengthIp =
+    std::integral<std::remove_cvref_t<T>> ||
+    (HasTupleSize<T> &&
+     !StringLike<T> &&
+     (is_homogeneous_tuple<T>()) &&
+     (detail::tuple_elements_integral<T>()));
+
+/**
+ * @brief Наибольшая длина IP-адреса типа `T`, без перевода строки.
+ *
+ * Буфер такой длины на стеке вмещает запись format_ip любого значения `T`.
+ *
+ * @tparam T Целочисленный тип, кортеж или std::array целых чисел.
+ */
+template<FixedLengthIp T>
+inline constexpr std::size_t kMaxIpLength = detail::max_ip_length<std::remove_cvref_t<T>>();
+
+/**
+ * @brief Пишет IP-адрес из целочисленного типа в буфер, без iostream.
+ *
+ * @tparam T Целочисленный тип.
+ * @param value Значение IP-адреса.
+ * @param out Буфер не меньше kMaxIpLength<T> символов.
+ * @return Указатель за последним записанным символом.
+ */
+template<std::integral T>
+constexpr char* format_ip(T value, char* out) noexcept {
+    using U = std::make_unsigned_t<T>;
+
+    const U unsigned_val = static_cast<U>(value);
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((out = detail::put_octet<I>(unsigned_val, out)), ...);
+    }(std::make_index_sequence<sizeof(T)>{});
+
+    return out;
+}
+
+/**
+ * @brief Копирует строковое представление IP-адреса в буфер.
+ *
+ * @tparam T Строкоподобный тип.
+ * @param str Строковое представление IP-адреса.
+ * @param out Буфер не меньше `str.size()` символов.
+ * @return Указатель за последним записанным символом.
+ */
+template<StringLike T>
+char* format_ip(const T& str, char* out) noexcept {
+    return std::copy(str.begin(), str.end(), out);
+}
+
+/**
+ * @brief Пишет IP-адрес из контейнера в буфер: элементы через точку.
+ *
+ * @tparam T Контейнер с целыми числами или строками.
+ * @param container Контейнер, содержащий значения.
+ * @param out Буфер не меньше format_ip_size(container) символов.
+ * @return Указатель за последним записанным символом.
+ */
+template<IpContainer T>
+    requires detail::IpElement<std::ranges::range_reference_t<const T&>>
+char* format_ip(const T& container, char* out) {
+    if constexpr (FixedLengthIp<T>) {
+        return detail::format_fixed(container, out);
+    }
+
+    bool first = true;
+
+    for (const auto& element : container) {
+        if (!first) *out++ = '.';
+        out = detail::format_element(element, out);
+        first = false;
+    }
+
+    return out;
+}
+
+/**
+ * @brief Пишет IP-адрес из однородного кортежа в буфер.
+ *
+ * @tparam T Однородный кортеж с целыми числами или строками.
+ * @param tpl Кортеж, содержащий значения.
+ * @param out Буфер не меньше format_ip_size(tpl) символов.
+ * @return Указатель за последним записанным символом.
+ */
+template<HomogeneousTuple T>
+    requires (detail::tuple_elements_formattable<T>())
+char* format_ip(const T& tpl, char* out) {
+    return detail::format_fixed(tpl, out);
+}
+
+/**
+ * @brief Верхняя граница длины записи format_ip для значения.
+ *
+ * @tparam T Любой тип, поддерживаемый format_ip.
+ * @param value Значение IP-адреса.
+ * @return Сколько символов достаточно буферу для format_ip(value, out).
+ */
+template<typename T>
+constexpr std::size_t format_ip_size(const T& value) {
+    if constexpr (FixedLengthIp<T>) {
+        return kMaxIpLength<T>;
+    } else if constexpr (StringLike<T>) {
+        return value.size();
+    } else if constexpr (IpContainer<T>) {
+        std::size_t size = 0;
+        for (const auto& element : value) size += detail::element_size(element) + 1;
+        return size;
+    } else {
+        return std::apply([](const auto&... args) {
+            return (std::size_t{0} + ... + (detail::element_size(args) + 1));
+        }, value);
+    }
+}
+
+/**
+ * @brief Дописывает IP-адрес в конец строки.
+ *
+ * @tparam T Любой тип, поддерживаемый format_ip.
+ * @param value Значение IP-адреса.
+ * @param out Строка, к которой дописывается адрес.
+ */
+template<typename T>
+    requires requires(const T& value, char* out) { format_ip(value, out); }
+void format_ip(const T& value, std::string& out) {
+    const std::size_t old_size = out.size();
+    out.resize(old_size + format_ip_size(value));
+
+    char* end = format_ip(value, out.data() + old_size);
+    out.resize(static_cast<std::size_t>(end - out.data()));
+}
+
+/**
+ * @brief Пишет IP-адреса из массива целых в буфер, каждый с новой строки.
+ *
+ * @tparam T Целочисленный тип.
+ * @param values Значения IP-адресов.
+ * @param out Буфер не меньше `values.size() * (kMaxIpLength<T> + 1)` символов.
+ * @return Указатель за последним записанным символом.
+ */
+template<std::integral T, std::size_t Extent>
+char* format_ips_scalar(std::span<T, Extent> values, char* out) noexcept {
+    for (const auto value : values) {
+        out = format_ip(value, out);
+        *out++ = '\n';
+    }
+
+    return out;
+}
+
+/**
+ * @brief То же, что format_ips_scalar, но группы адресов переводятся в
+ * текст векторным ядром AVX2.
+ *
+ * Годится только для 4- и 8-байтных целых и только если
+ * detail::has_avx2_formatter() вернула true. Остаток меньше группы
+ * дописывается скалярно.
+ *
+ * @tparam T 4- или 8-байтный целочисленный тип.
+ * @param values Значения IP-адресов.
+ * @param out Буфер не меньше `values.size() * (kMaxIpLength<T> + 1)` символов.
+ * @return Указатель за последним записанным символом.
+ */
+template<std::integral T, std::size_t Extent>
+    requires (sizeof(T) == 4 || sizeof(T) == 8)
+char* format_ips_avx2(std::span<T, Extent> values, char* out) noexcept {
+    constexpr std::size_t group = 16 / sizeof(T);
+    const std::size_t vectorized = values.size() / group * group;
+
+    out = detail::format_dotted_avx2<sizeof(T) == 8>(reinterpret_cast<const unsigned char*>(values.data()),
+                                                     vectorized * sizeof(T) / 4, out);
+    return format_ips_scalar(values.subspan(vectorized), out);
+}
+
+/**
+ * @brief Дописывает в строку IP-адреса из массива целых, каждый с новой строки.
+ *
+ * Память под всю пачку выделяется один раз. 4- и 8-байтные целые идут
+ * через format_ips_avx2, если процессор его поддерживает.
+ *
+ * @tparam T Целочисленный тип.
+ * @param values Значения IP-адресов.
+ * @param out Строка, к которой дописываются адреса.
+ */
+template<std::integral T, std::size_t Extent>
+void format_ips(std::span<T, Extent> values, std::string& out) {
+    const std::size_t old_size = out.size();
+    out.resize(old_size + values.size() * (kMaxIpLength<std::remove_cv_t<T>> + 1));
+
+    char* cursor = out.data() + old_size;
+    if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+        cursor = detail::has_avx2_formatter() ? format_ips_avx2(values, cursor) : format_ips_scalar(values, cursor);
+    } else {
+        cursor = format_ips_scalar(values, cursor);
+    }
+
+    out.resize(static_cast<std::size_t>(cursor - out.data()));
+}
+
+/**
+ * @brief Выводит IP-адреса из массива целых в файловый дескриптор.
+ *
+ * Весь текст собирается в одном буфере и уходит одним вызовом `write`;
+ * повторные вызовы нужны, только если ядро приняло его не целиком.
+ *
+ * @tparam T Целочисленный тип.
+ * @param values Значения IP-адресов.
+ * @param fd Файловый дескриптор.
+ * @return true, если записан весь текст; иначе false, причина в errno.
+ */
+template<std::integral T, std::size_t Extent>
+bool write_ips(std::span<T, Extent> values, int fd) {
+    std::string text;
+    format_ips(values, text);
+
+    std::string_view left = text;
+    while (!left.empty()) {
+        const auto written = ::write(fd, left.data(), left.size());
+        if (written < 0) return false;
+        left.remove_prefix(static_cast<std::size_t>(written));
+    }
+
+    return true;
+}
+
+namespace detail {
+
+/**
+ * @brief Выводит IP-адрес с переводом строки одним вызовом `std::cout.write`.
+ *
+ * Запись типа с наибольшей длиной, известной при компиляции, собирается в
+ * буфере на стеке, остальные в std::string.
+ */
+template<typename T>
+void print_line(const T& value) {
+    if constexpr (FixedLengthIp<T>) {
+        char line[kMaxIpLength<T> + 1];
+        char* end = format_ip(value, line);
+        *end++ = '\n';
+
+        std::cout.write(line, end - line);
+    } else {
+        std::string line;
+        format_ip(value, line);
+        line += '\n';
+
+        std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Печатает IP-адрес для целочисленного типа.
+ *
+ * @tparam T Целочисленный тип.
+ * @param value Значение IP-адреса.
+ */
+template<std::integral T>
+void print_ip(T value) {
+    detail::print_line(value);
+}
+
+/**
+ * @brief Печатает IP-адрес, если значение является строкой.
+ *
+ * @tparam T Строкоподобный тип.
+ * @param str Строковое представление IP-адреса.
+ */
+template<StringLike T>
+void print_ip(T&& str) {
+    std::cout << str << "\n";
+}
+
+/**
+ * @brief Печатает IP-адрес из контейнера (например, vector, list).
+ *
+ * Элементы, которые не умеет выводить format_ip (например, double),
+ * печатаются через `std::cout <<`.
+ *
+ * @tparam T Контейнер для IP-адреса.
+ * @param container Контейнер, содержащий значения.
+ */
+template<IpContainer T>
+void print_ip(T&& container) {
+    if constexpr (requires(std::string& out) { format_ip(container, out); }) {
+        detail::print_line(container);
+    } else {
+        bool first = true;
+        for (const auto& element : container) {
+            if (!first) std::cout << ".";
+            std::cout << element;
+            first = false;
+        }
+
+        std::cout << "\n";
+    }
+}
+
+/**
+ * @brief Печатает IP-адрес из однородного кортежа.
+ *
+ * Элементы, которые не умеет выводить format_ip, печатаются через
+ * `std::cout <<`.
+ *
+ * @tparam T Однородный кортеж.
+ * @param tpl Кортеж, содержащий значения.
+ */
+template<HomogeneousTuple T>
+void print_ip(T&& tpl) {
+    if constexpr (requires(std::string& out) { format_ip(tpl, out); }) {
+        detail::print_line(tpl);
+    } else {
+        std::apply([](const auto&... args) {
+            std::size_t n = 0;
+            ((std::cout << (n++ == 0 ? "" : ".") << args), ...);
+        }, tpl);
+
+        std::cout << "\n";
+    }
+}
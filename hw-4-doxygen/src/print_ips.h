@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "src/print_ip.h"
+
+/**
+ * @brief Сколько адресов форматирует поток за один раз в print_ips.
+ */
+inline constexpr std::size_t kPrintIpsChunk = 16384;
+
+/**
+ * @brief Диапазон адресов для print_ips: с произвольным доступом, известного
+ * размера, из значений, которые умеет выводить format_ip.
+ *
+ * @tparam R Тип, который будет проверяться.
+ */
+template<typename R>
+concept PrintableIpRange =
+    std::ranges::random_access_range<R> &&
+    std::ranges::sized_range<R> &&
+    requires(const std::ranges::range_value_t<R>& value, std::string& out) { format_ip(value, out); };
+
+namespace detail {
+
+/**
+ * @brief Дописывает в строку адреса [first, first + count), каждый с новой строки.
+ */
+template<typename It>
+void format_chunk(It first, std::size_t count, std::string& out) {
+    using Value = std::iter_value_t<It>;
+
+    if constexpr (std::contiguous_iterator<It> && std::integral<Value>) {
+        format_ips(std::span(std::to_address(first), count), out);
+    } else {
+        for (std::size_t i = 0; i < count; ++i, ++first) {
+            format_ip(*first, out);
+            out += '\n';
+        }
+    }
+}
+
+/**
+ * @brief Пишет буферы в файловый дескриптор через writev, дописывая хвост
+ * после неполной записи.
+ *
+ * @return true, если записано всё; иначе false, причина в errno.
+ */
+inline bool write_all(std::span<iovec> buffers, int fd) {
+    while (!buffers.empty()) {
+        const auto count = static_cast<int>(std::min<std::size_t>(buffers.size(), IOV_MAX));
+        auto written = ::writev(fd, buffers.data(), count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        while (!buffers.empty() && static_cast<std::size_t>(written) >= buffers.front().iov_len) {
+            written -= static_cast<ssize_t>(buffers.front().iov_len);
+            buffers = buffers.subspan(1);
+        }
+        if (!buffers.empty()) {
+            buffers.front().iov_base = static_cast<char*>(buffers.front().iov_base) + written;
+            buffers.front().iov_len -= static_cast<std::size_t>(written);
+        }
+    }
+
+    return true;
+}
+
+} // namespace detail
+
+/**
+ * @brief Выводит IP-адреса из диапазона в файловый дескриптор, форматируя
+ * их в нескольких потоках.
+ *
+ * Диапазон режется на куски по kPrintIpsChunk адресов. Кусок `c`
+ * форматирует поток `c % threads` в свой буфер. Буферов вдвое больше, чем
+ * потоков, так что поток может уйти вперёд на один кусок. Вызывающий поток
+ * забирает готовые куски строго по порядку и пишет подряд идущие одним
+ * `writev`. Вывод совпадает с последовательными вызовами print_ip для
+ * каждого элемента.
+ *
+ * Исключение при форматировании или при запуске потока останавливает
+ * вывод: все потоки завершаются, и исключение летит из print_ips.
+ *
+ * @tparam R Диапазон адресов с произвольным доступом.
+ * @param range Адреса.
+ * @param fd Файловый дескриптор.
+ * @param threads Число потоков форматирования; 0 — по числу ядер.
+ * @return true, если записан весь текст; иначе false, причина в errno.
+ */
+template<PrintableIpRange R>
+bool print_ips(R&& range, int fd, unsigned threads = 0) {
+    const std::size_t size = std::ranges::size(range);
+    const std::size_t chunks = (size + kPrintIpsChunk - 1) / kPrintIpsChunk;
+    const auto first = std::ranges::begin(range);
+
+    auto chunk_length = [size](std::size_t chunk) { return std::min(kPrintIpsChunk, size - chunk * kPrintIpsChunk); };
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, chunks));
+
+    if (threads <= 1) {
+        std::string text;
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            text.clear();
+            detail::format_chunk(first + static_cast<std::ptrdiff_t>(chunk * kPrintIpsChunk), chunk_length(chunk), text);
+
+            iovec buffer{text.data(), text.size()};
+            if (!detail::write_all(std::span(&buffer, 1), fd)) return false;
+        }
+        return true;
+    }
+
+    // Состояние буфера: 2c — свободен для куска c, 2c + 1 — в нём готовый кусок c.
+    struct Slot {
+        std::string text;
+        std::atomic<std::size_t> state;
+        std::exception_ptr error; // пишется до kStopped, читается после него
+    };
+    constexpr std::size_t kStopped = static_cast<std::size_t>(-1);
+
+    const std::size_t slot_count = 2 * std::size_t{threads};
+    const auto slots = std::make_unique<Slot[]>(slot_count);
+    for (std::size_t i = 0; i < slot_count; ++i) slots[i].state.store(2 * i, std::memory_order_relaxed);
+
+    // ждёт, пока состояние станет `target`; false, если вывод остановлен
+    auto wait_for = [](std::atomic<std::size_t>& state, std::size_t target) {
+        for (auto seen = state.load(std::memory_order_acquire); seen != target; seen = state.load(std::memory_order_acquire)) {
+            if (seen == kStopped) return false;
+            state.wait(seen, std::memory_order_acquire);
+        }
+        return true;
+    };
+
+    // будит всех, кто ждёт, и не даёт браться за новые куски
+    auto stop_all = [&] {
+        for (std::size_t i = 0; i < slot_count; ++i) {
+            slots[i].state.store(kStopped, std::memory_order_release);
+            slots[i].state.notify_all();
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    workers.reserve(threads);
+    try {
+        for (unsigned worker = 0; worker < threads; ++worker) {
+            workers.emplace_back([&, worker] {
+                for (std::size_t chunk = worker; chunk < chunks; chunk += threads) {
+                    Slot& slot = slots[chunk % slot_count];
+                    if (!wait_for(slot.state, 2 * chunk)) return;
+
+                    try {
+                        slot.text.clear();
+                        detail::format_chunk(first + static_cast<std::ptrdiff_t>(chunk * kPrintIpsChunk),
+                                             chunk_length(chunk), slot.text);
+                    } catch (...) {
+                        // вызывающий поток увидит kStopped в этом буфере и пробросит исключение
+                        slot.error = std::current_exception();
+                        slot.state.store(kStopped, std::memory_order_release);
+                        slot.state.notify_all();
+                        return;
+                    }
+
+                    slot.state.store(2 * chunk + 1, std::memory_order_release);
+                    slot.state.notify_all();
+                }
+            });
+        }
+    } catch (...) {
+        // уже запущенные потоки ждут буферы, которые никто не освободит
+        stop_all();
+        throw;
+    }
+
+    std::vector<iovec> ready;
+    ready.reserve(slot_count);
+
+    bool ok = true;
+    std::exception_ptr error;
+    for (std::size_t next = 0; next < chunks && ok;) {
+        if (!wait_for(slots[next % slot_count].state, 2 * next + 1)) {
+            error = slots[next % slot_count].error;
+            break;
+        }
+
+        // всё, что уже готово подряд, уходит одним writev
+        std::size_t end = next;
+        do {
+            auto& text = slots[end % slot_count].text;
+            ready.push_back({text.data(), text.size()});
+            ++end;
+        } while (end < chunks && end - next < slot_count &&
+                 slots[end % slot_count].state.load(std::memory_order_acquire) == 2 * end + 1);
+
+        ok = detail::write_all(ready, fd);
+        ready.clear();
+
+        for (; next < end; ++next) {
+            auto& state = slots[next % slot_count].state;
+            state.store(ok ? 2 * (next + slot_count) : kStopped, std::memory_order_release);
+            state.notify_all();
+        }
+    }
+
+    if (error) {
+        stop_all();
+        workers.clear();
+        std::rethrow_exception(error);
+    }
+
+    if (!ok) {
+        const int saved_errno = errno;
+        stop_all();
+        workers.clear();
+        errno = saved_errno;
+    }
+
+    return ok;
+}